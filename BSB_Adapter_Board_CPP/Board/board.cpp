@@ -5,21 +5,140 @@
 #include "scheduler.h"
 #include "lcd.h"
 #include "adc.h"
-#include <util/delay.h>
+#include "adc_filter.h"
+#include "adc_window.h"
+#include "adc_stats.h"
+#include "tasks.h"
+#include "watchdog.h"
+#include "config.h"
+#include "postmortem.h"
+#include "log.h"
 
 /**
- * @brief Initializes all essential hardware components of the board.
- *
- * This function should be called once at the beginning of main().
- * It initializes:
- *   - Timer0 for millisecond timing
- *   - GPIO configuration for default LEDs or I/Os
- *
- * You can extend this function to initialize other subsystems like UART, I2C, etc.
+ * @brief Scheduler idle hook: lets the ADC start a sleeping conversion.
  */
+static void boardIdle(void)
+{
+	adc.idle();
+}
+
+/**
+ * @brief ADC window event handler (ADC_vect context): wake the alarm task.
+ */
+static void adcAlarmNotify(void)
+{
+	scheduler.notify(adcAlarmTask);
+}
 
 LCD lcd(APG1, APB4, APE6, APH0, APH1, APH2, APH3, APH4 , APH5, APH6, APH7);
 
+// Channels swept by the background ADC scanner (A0-A15)
+static const uint8_t adcScanList[] = {
+	0, 1, 2, 3, 4, 5, 6, 7,
+	8, 9, 10, 11, 12, 13, 14, 15
+};
+
+// Channels with running statistics (one adcStats slot each)
+static const uint8_t adcStatsList[] = { 0, 1, 2, 3 };
+static_assert(sizeof(adcStatsList) <= ADC_STATS_SLOTS, "adcStatsList needs more ADC_STATS_SLOTS");
+
+/*
+ * Staged bring-up
+ *
+ * One step per scheduler pass; waits (LCD power-up) are left to the
+ * peripheral's own task instead of _delay_ms().
+ */
+enum BoardInitState {
+	INIT_SERIAL,
+	INIT_ADC,
+	INIT_LCD,
+	INIT_LCD_WAIT,
+	INIT_REPORT,
+	INIT_DONE
+};
+
+static uint8_t initState = INIT_SERIAL;
+
+static void initSerial(void)
+{
+	Serial3.begin(config.get().serialBaud);
+	logSetSink(&Serial3);
+	LOG_INFO(BOARD, "BSB_Adapter_Paltine sagt Hallo...!");
+	watchdog.report(); // Tell why the previous run ended
+}
+
+static void initAdc(void)
+{
+    adc.init(ADC_MODE_SCAN);		  // Use default: 125 kHz ADC clock, interrupt-driven scan
+    adc.setReference(config.get().adcReference);
+    adc.setResolution(config.get().adcResolution);
+
+    // Reject single-sample spikes, then smooth (alpha = 1/4)
+    const AdcFilterConfig sensorFilter = { 3, 2, 0 };
+    for (uint8_t ch = 0; ch < sizeof(adcScanList); ++ch) {
+        adcFilters.configure(adcScanList[ch], sensorFilter);
+        adc.setChannelDiscard(adcScanList[ch], 1);  // Let the S/H settle after each mux switch
+    }
+    for (uint8_t i = 0; i < sizeof(adcStatsList); ++i) {
+        adcStats.configure(adcStatsList[i], 1000, 4);  // ~1 min tumbling, sliding in 15 s steps
+    }
+    adc.setFilterBank(&adcFilters);
+
+    // Limit checks in the scan ISR; crossings wake adcAlarmTask
+    // adcWindows.setWindow(0, 100, 900, 10);   // e.g. A0 must stay within 100..900
+    adcWindows.setHandler(adcAlarmNotify);
+    adc.setWindowComparator(&adcWindows);
+    adc.setStatsBank(&adcStats);
+    adc.startScan(adcScanList, sizeof(adcScanList), 8);  // 1 discard + 8x oversampling, ~15 ms per sweep
+    scheduler.setIdleHook(boardIdle);
+    // adc.setNoiseReduction(true);   // Sleep during scan conversions; drops UART RX bytes (see adc.h)
+}
+
+/**
+ * @brief Bring-up task (1 ms): runs the next init step, removes itself
+ * when all peripherals are ready and the post-mortem log is out.
+ */
+static void boardInitTask(void)
+{
+	switch (initState) {
+		case INIT_SERIAL:
+		initSerial();
+		scheduler.setReady(BOARD_READY_SERIAL);
+		initState = INIT_ADC;
+		break;
+
+		case INIT_ADC:
+		initAdc();
+		scheduler.setReady(BOARD_READY_ADC);
+		initState = INIT_LCD;
+		break;
+
+		case INIT_LCD:
+		lcd.setQueued(true);   // Init and refreshes are sent by lcdServiceTask
+		lcd.begin(config.get().lcdCols, config.get().lcdRows);
+		initState = INIT_LCD_WAIT;
+		break;
+
+		case INIT_LCD_WAIT:
+		if (!lcd.idle()) break;  // 50 ms power-up wait runs in lcdServiceTask
+		scheduler.setReady(BOARD_READY_LCD);
+		LOG_INFO(BOARD, "ready after %lu ms", (unsigned long)schedulerTicks());
+		initState = INIT_REPORT;
+		break;
+
+		case INIT_REPORT:
+		// Post-mortem log through the log sink, one line whenever the
+		// previous one is out; ~0.7 s for a full log at 9600 baud
+		if (postmortem.reportStep()) break;
+		initState = INIT_DONE;
+		break;
+
+		default:
+		scheduler.removeTask(boardInitTask);
+		break;
+	}
+}
+
 void Board_Init(void)
 {
 
@@ -27,31 +146,11 @@ void Board_Init(void)
     pinMode(LED_P2, OUTPUT);
     digitalWrite(LED_P2, LOW);  // Ensure LED starts in OFF state
 
-    // === Optional Future Initializations ===
-    // init_uart();
-	
-	Serial3.begin(9600);
-	_delay_ms(500);
-	Serial3.println("BSB_Adapter_Paltine sagt Hallo...!");
-	
-	scheduler.begin(); // Tasks are initialized inside function
+    config.begin();  // EEPROM record or defaults; scheduler.begin() needs it
 
-		
+    // Peripherals come up in boardInitTask once scheduler.begin() runs
     // init_i2c();
-	
-    // init_adc();
-	
-    
-    adc.init(ADC_MODE_SINGLE);		  // Use default: 125 kHz ADC clock, single conversion mode
-    adc.setReference(MODE_AVCC);      
-    adc.setResolution(10);
-	  
-	
-    // init_lcd();
-	
-	lcd.begin(16,2);
-	_delay_ms(100);
-	
-	
     // init_buttons();
+    initState = INIT_SERIAL;
+    scheduler.addTask(boardInitTask, 0, 1, 20);   // One step per ms; output goes through the log ring
 }
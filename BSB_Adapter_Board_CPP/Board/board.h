@@ -13,6 +13,11 @@
 // Define the LED pin using a custom macro (e.g., APB7 style)
 #define LED_P2 APB7
 
+// Readiness flags set by the bring-up task (see Scheduler::setReady)
+#define BOARD_READY_SERIAL  (1 << 0)  // Serial3 up, log sink set
+#define BOARD_READY_ADC     (1 << 1)  // Scan running
+#define BOARD_READY_LCD     (1 << 2)  // Init sequence on the glass
+
 // LCD pin configuration:
 // RS -> D12, RW -> D10, EN -> D11
 // D4~D7 -> D5, D4, D3, D2 
@@ -25,13 +30,12 @@ extern "C" {
 
 
 /**
- * @brief Initializes all board-level drivers and GPIOs.
- *
- * This includes:
- * - Timer0 for millis()
- * - GPIO setup for default board pins
+ * @brief Sets up the board GPIOs and registers the bring-up task.
  *
- * Call this once in main().
+ * Call this once in main() before scheduler.begin(). The peripherals
+ * (Serial3, ADC, LCD) are then initialised step by step by a 1 ms task;
+ * each sets its BOARD_READY_* flag when done, and tasks that require it
+ * start running from then on. Nothing here blocks.
  */
 void Board_Init(void);
 
@@ -0,0 +1,160 @@
+#include "config.h"
+#include "adc.h"
+#include "lcd.h"
+#include "scheduler.h"
+#include <avr/eeprom.h>
+#include <util/crc16.h>
+#include <string.h>
+#include "metrics.h"
+
+#define CONFIG_MAGIC        0xB5C0
+#define CONFIG_HEADER_SIZE  6
+
+// Serial3 rates the 12-bit UBRR divider can reach at 16 MHz
+#define CONFIG_BAUD_MIN     300UL
+#define CONFIG_BAUD_MAX     1000000UL
+
+static_assert(CONFIG_HEADER_SIZE + sizeof(BoardConfig) + 2 <= CONFIG_SLOT_SIZE,
+              "BoardConfig does not fit into CONFIG_SLOT_SIZE");
+
+ConfigStore config;
+
+static const BoardConfig configDefaults = {
+	9600,        // serialBaud
+	MODE_AVCC,   // adcReference
+	10,          // adcResolution
+	16, 2,       // lcdCols, lcdRows
+	150,         // blinkPeriod
+	1000,        // uartPeriod
+	1000,        // lcdPeriod
+	100,         // adcPeriod
+	250          // statsPeriod
+};
+
+/**
+ * A record with a good CRC may still carry values this firmware cannot
+ * use (another firmware version, a bad edit()): baud 0 divides by zero,
+ * 0 LCD rows underflows the row index, a 0 ms period runs a task every
+ * tick. Each field outside its range gets its default back.
+ */
+static void checkRanges(BoardConfig& c) {
+	const BoardConfig& d = configDefaults;
+
+	if (c.serialBaud < CONFIG_BAUD_MIN || c.serialBaud > CONFIG_BAUD_MAX) c.serialBaud = d.serialBaud;
+	if (c.adcReference > MODE_INT_2V56) c.adcReference = d.adcReference;
+	if (c.adcResolution < 8 || c.adcResolution > 13) c.adcResolution = d.adcResolution;
+	if (c.lcdCols == 0 || c.lcdCols > LCD_MAX_COLS) c.lcdCols = d.lcdCols;
+	if (c.lcdRows == 0 || c.lcdRows > LCD_MAX_ROWS) c.lcdRows = d.lcdRows;
+
+	// SCHED_EVENT would turn a periodic task into one that never runs
+	if (c.blinkPeriod == 0 || c.blinkPeriod == SCHED_EVENT) c.blinkPeriod = d.blinkPeriod;
+	if (c.uartPeriod == 0 || c.uartPeriod == SCHED_EVENT) c.uartPeriod = d.uartPeriod;
+	if (c.lcdPeriod == 0 || c.lcdPeriod == SCHED_EVENT) c.lcdPeriod = d.lcdPeriod;
+	if (c.adcPeriod == 0 || c.adcPeriod == SCHED_EVENT) c.adcPeriod = d.adcPeriod;
+	if (c.statsPeriod == 0 || c.statsPeriod == SCHED_EVENT) c.statsPeriod = d.statsPeriod;
+}
+
+uint8_t* ConfigStore::slotAddress(uint8_t slot) {
+	return (uint8_t*)(uintptr_t)(CONFIG_EEPROM_BASE + (uint16_t)slot * CONFIG_SLOT_SIZE);
+}
+
+uint16_t ConfigStore::crc(const uint8_t* data, uint8_t length) {
+	uint16_t c = 0xFFFF;
+	for (uint8_t i = 0; i < length; ++i) {
+		c = _crc_ccitt_update(c, data[i]);
+	}
+	return c;
+}
+
+bool ConfigStore::begin() {
+	const uint8_t length = CONFIG_HEADER_SIZE + sizeof(BoardConfig);
+	uint8_t buffer[CONFIG_SLOT_SIZE];
+	bool found = false;
+
+	for (uint8_t s = 0; s < CONFIG_SLOTS; ++s) {
+		eeprom_read_block(buffer, slotAddress(s), length + 2);
+
+		uint16_t magic = buffer[0] | (buffer[1] << 8);
+		uint16_t seq = buffer[4] | (buffer[5] << 8);
+		uint16_t stored = buffer[length] | (buffer[length + 1] << 8);
+		if (magic != CONFIG_MAGIC || buffer[2] != CONFIG_VERSION ||
+		    buffer[3] != sizeof(BoardConfig) || crc(buffer, length) != stored) {
+			continue;
+		}
+
+		// Newest wins; the difference handles sequence wrap-around
+		if (!found || (int16_t)(seq - _sequence) > 0) {
+			memcpy(&_config, buffer + CONFIG_HEADER_SIZE, sizeof(BoardConfig));
+			_sequence = seq;
+			_slot = s;
+			found = true;
+		}
+	}
+
+	if (!found) restoreDefaults();
+	checkRanges(_config);
+	return found;
+}
+
+void ConfigStore::restoreDefaults() {
+	_config = configDefaults;
+}
+
+void ConfigStore::save() {
+	checkRanges(_config);
+	stage();
+}
+
+/**
+ * Builds the slot image for the next sequence number. The image is taken
+ * from the RAM copy now, so later edits need another save().
+ */
+void ConfigStore::stage() {
+	const uint8_t length = CONFIG_HEADER_SIZE + sizeof(BoardConfig);
+
+	// A save during a pending write reuses the slot being written
+	if (!pending()) {
+		_writeSlot = (_slot + 1) % CONFIG_SLOTS;
+	}
+	uint16_t seq = _sequence + 1;
+
+	memset(_image, 0xFF, sizeof(_image));
+	_image[0] = CONFIG_MAGIC & 0xFF;
+	_image[1] = CONFIG_MAGIC >> 8;
+	_image[2] = CONFIG_VERSION;
+	_image[3] = sizeof(BoardConfig);
+	_image[4] = seq & 0xFF;
+	_image[5] = seq >> 8;
+	memcpy(_image + CONFIG_HEADER_SIZE, &_config, sizeof(BoardConfig));
+
+	uint16_t c = crc(_image, length);
+	_image[length] = c & 0xFF;
+	_image[length + 1] = c >> 8;
+
+	_writeIndex = 0;
+}
+
+/**
+ * Skips bytes the slot already holds (a read takes a few cycles) and
+ * starts at most one EEPROM write. When the last byte is through, the
+ * slot becomes the current record.
+ */
+void ConfigStore::service() {
+	if (!pending() || !eeprom_is_ready()) return;
+
+	const uint8_t length = CONFIG_HEADER_SIZE + sizeof(BoardConfig) + 2;
+	uint8_t* base = slotAddress(_writeSlot);
+
+	while (_writeIndex < length) {
+		uint8_t i = _writeIndex++;
+		if (eeprom_read_byte(base + i) != _image[i]) {
+			eeprom_write_byte(base + i, _image[i]);  // Returns at once, EEPE runs ~3.3 ms
+			METRIC_INC(CONFIG_WRITES);
+			return;
+		}
+	}
+
+	_writeIndex = CONFIG_SLOT_SIZE;
+	_slot = _writeSlot;
+	_sequence++;
+}
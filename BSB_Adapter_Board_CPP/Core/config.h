@@ -0,0 +1,96 @@
+#ifndef CONFIG_H_
+#define CONFIG_H_
+
+#include <stdint.h>
+
+/**
+ * @file config.h
+ * @brief Board configuration record kept in EEPROM.
+ *
+ * The record is loaded once at boot (before scheduler.begin()) and then
+ * read from RAM. save() only stages a new image; configTask() writes it
+ * to EEPROM one byte per call whenever the EEPROM is idle, so a write
+ * (3.3 ms per byte) never blocks the scheduler.
+ *
+ * EEPROM layout: CONFIG_SLOTS slots of CONFIG_SLOT_SIZE bytes. Each save
+ * goes to the slot after the current one (wear levelling), and only the
+ * bytes that differ from that slot's old contents are written.
+ *
+ *     magic(2) version(1) size(1) sequence(2) | BoardConfig | crc16(2)
+ *
+ * The CRC (CCITT) covers header and data. At boot the valid slot with the
+ * newest sequence wins; a slot torn by a reset fails its CRC, so the
+ * previous one is used. Without any valid slot the defaults apply.
+ * begin() and save() replace each out-of-range field with its default.
+ *
+ * Adding a field: append it to BoardConfig, set its default in
+ * config.cpp and bump CONFIG_VERSION (older records fall back to defaults).
+ */
+
+#define CONFIG_VERSION      1
+#define CONFIG_SLOTS        4
+#define CONFIG_SLOT_SIZE    64
+#define CONFIG_EEPROM_BASE  0      // First byte of slot 0
+
+struct BoardConfig {
+	uint32_t serialBaud;       // Serial3 baud rate
+	uint8_t  adcReference;     // MODE_xx (adc.h)
+	uint8_t  adcResolution;    // 8-13 bits
+	uint8_t  lcdCols;
+	uint8_t  lcdRows;
+	uint16_t blinkPeriod;      // Task periods in ms
+	uint16_t uartPeriod;
+	uint16_t lcdPeriod;
+	uint16_t adcPeriod;
+	uint16_t statsPeriod;
+};
+
+class ConfigStore {
+	public:
+	/**
+	 * @brief Loads the newest valid slot, or the defaults.
+	 * @return true if a stored record was found
+	 */
+	bool begin();
+
+	const BoardConfig& get() const { return _config; }
+
+	/**
+	 * @brief Writable RAM copy; call save() after changing it.
+	 */
+	BoardConfig& edit() { return _config; }
+
+	/**
+	 * @brief Stages the RAM copy for write-behind into the next slot.
+	 * Out-of-range fields are reset to their defaults first. A save
+	 * during a pending write restarts it with the newer contents.
+	 */
+	void save();
+
+	void restoreDefaults();        // Defaults into RAM (save() to persist)
+
+	/**
+	 * @brief Writes at most one changed byte; call from a low-priority task.
+	 */
+	void service();
+
+	bool pending() const { return _writeIndex < CONFIG_SLOT_SIZE; }
+	uint16_t sequence() const { return _sequence; }
+	uint8_t slot() const { return _slot; }
+
+	private:
+	void stage();
+	static uint16_t crc(const uint8_t* data, uint8_t length);
+	static uint8_t* slotAddress(uint8_t slot);
+
+	BoardConfig _config;
+	uint8_t _image[CONFIG_SLOT_SIZE];  // Slot contents being written
+	uint8_t _writeSlot = 0;
+	uint8_t _writeIndex = CONFIG_SLOT_SIZE;  // Next image byte (SLOT_SIZE = idle)
+	uint8_t _slot = CONFIG_SLOTS - 1;        // Slot of the current record
+	uint16_t _sequence = 0;
+};
+
+extern ConfigStore config;
+
+#endif /* CONFIG_H_ */
@@ -0,0 +1,99 @@
+#include "log.h"
+#include "serial.h"
+#include "scheduler.h"
+#include "metrics.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Tag names in flash
+#define LOG_TAG_NAME(tag) static const char logTagName_##tag[] PROGMEM = #tag;
+LOG_TAGS(LOG_TAG_NAME)
+#undef LOG_TAG_NAME
+
+static const char* const logTagNames[LOG_TAG_COUNT] PROGMEM = {
+#define LOG_TAG_PTR(tag) logTagName_##tag,
+	LOG_TAGS(LOG_TAG_PTR)
+#undef LOG_TAG_PTR
+};
+
+static const char logLevelChars[] = "?EWID";
+
+// Single producer/consumer context (tasks): no locking needed
+static char logRing[LOG_BUFFER_SIZE];
+static uint8_t logHead = 0;
+static uint8_t logTail = 0;
+static uint16_t logDrops = 0;
+static SerialClass* logSink = nullptr;
+
+static uint8_t logFree() {
+	return (LOG_BUFFER_SIZE - 1) - (uint8_t)(logHead - logTail);
+}
+
+/**
+ * Task context only. The record is formatted on the stack first and then
+ * copied in as a whole, so the ring never holds half a line.
+ */
+void logWrite(uint8_t level, uint8_t tag, const char* fmt_P, ...) {
+	if (!logSink) return;
+
+	char line[LOG_LINE_MAX];
+	uint8_t n;
+
+	ultoa(schedulerTicks(), line, 10);
+	n = strlen(line);
+	line[n++] = ' ';
+	line[n++] = logLevelChars[level <= LOG_LEVEL_DEBUG ? level : 0];
+	line[n++] = ' ';
+	if (tag < LOG_TAG_COUNT) {
+		strcpy_P(line + n, (const char*)pgm_read_ptr(&logTagNames[tag]));
+		n += strlen(line + n);
+	}
+	line[n++] = ':';
+	line[n++] = ' ';
+
+	va_list ap;
+	va_start(ap, fmt_P);
+	int len = vsnprintf_P(line + n, sizeof(line) - n - 2, fmt_P, ap);
+	va_end(ap);
+	if (len > 0) {
+		n += (len < (int)(sizeof(line) - n - 2)) ? len : sizeof(line) - n - 3;
+	}
+	line[n++] = '\r';
+	line[n++] = '\n';
+
+	if (n > logFree()) {
+		logDrops++;
+		METRIC_INC(LOG_DROPS);
+		return;
+	}
+
+	for (uint8_t i = 0; i < n; ++i) {
+		logRing[logHead] = line[i];
+		logHead = (logHead + 1) & (LOG_BUFFER_SIZE - 1);
+	}
+}
+
+void logSetSink(SerialClass* port) {
+	logSink = port;
+	if (!port) logTail = logHead;   // Discard what is queued
+}
+
+void logService() {
+	if (!logSink) return;
+
+	// Only while UDRn is empty: write() then returns without waiting
+	while (logTail != logHead && logSink->writeReady()) {
+		logSink->write(logRing[logTail]);
+		logTail = (logTail + 1) & (LOG_BUFFER_SIZE - 1);
+	}
+}
+
+uint16_t logDropped() {
+	return logDrops;
+}
+
+bool logIdle() {
+	return logTail == logHead;
+}
@@ -0,0 +1,121 @@
+#ifndef LOG_H_
+#define LOG_H_
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+/**
+ * @file log.h
+ * @brief Levelled, tagged logging into a non-blocking buffered sink.
+ *
+ *     LOG_INFO(ADC, "alarm A%u %u", ch, value);
+ *
+ * Levels below LOG_LEVEL (global) or LOG_LEVEL_<tag> (per module) are
+ * removed by the compiler, format string included. The
+ * format string stays in flash (PSTR) and is expanded with vsnprintf_P
+ * into the record ring. logTask() moves the ring to the sink port only as
+ * fast as the UART data register frees up, so a log call never waits
+ * for the UART. A record that does not fit is dropped and counted.
+ *
+ * Output line: "<ms> <level> <TAG>: <text>\r\n"
+ *
+ * Tasks that still print to Serial3 directly (ADC reports, console
+ * dumps) start a line only when logIdle() and finish it within the same
+ * run, so a record and a direct line never interleave. New debug output
+ * should use LOG_xx.
+ */
+
+#define LOG_LEVEL_NONE   0
+#define LOG_LEVEL_ERROR  1
+#define LOG_LEVEL_WARN   2
+#define LOG_LEVEL_INFO   3
+#define LOG_LEVEL_DEBUG  4
+
+// Debug builds (Atmel Studio defines DEBUG) keep everything
+#ifndef LOG_LEVEL
+#ifdef DEBUG
+#define LOG_LEVEL LOG_LEVEL_DEBUG
+#else
+#define LOG_LEVEL LOG_LEVEL_WARN
+#endif
+#endif
+
+// Modules; a per-module LOG_LEVEL_<tag> may lower (not raise) LOG_LEVEL
+#define LOG_TAGS(X) \
+	X(BOARD) \
+	X(SCHED) \
+	X(UART)  \
+	X(ADC)   \
+	X(LCD)   \
+	X(CONFIG)
+
+enum LogTag {
+#define LOG_TAG_ENUM(tag) LOG_TAG_##tag,
+	LOG_TAGS(LOG_TAG_ENUM)
+#undef LOG_TAG_ENUM
+	LOG_TAG_COUNT
+};
+
+#ifndef LOG_LEVEL_BOARD
+#define LOG_LEVEL_BOARD  LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_SCHED
+#define LOG_LEVEL_SCHED  LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_UART
+#define LOG_LEVEL_UART   LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_ADC
+#define LOG_LEVEL_ADC    LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_LCD
+#define LOG_LEVEL_LCD    LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_CONFIG
+#define LOG_LEVEL_CONFIG LOG_LEVEL
+#endif
+
+#define LOG_BUFFER_SIZE  256   // Ring bytes (power of two)
+#define LOG_LINE_MAX     64    // Longest record incl. prefix, longer text is cut
+
+class SerialClass;
+
+/**
+ * @brief Formats one record into the ring (use the LOG_xx macros).
+ */
+void logWrite(uint8_t level, uint8_t tag, const char* fmt_P, ...);
+
+/**
+ * @brief Routes the ring to port; nullptr discards records.
+ */
+void logSetSink(SerialClass* port);
+
+/**
+ * @brief Sends what the UART accepts right now; call every 1 ms.
+ */
+void logService();
+
+uint16_t logDropped();   // Records lost to a full ring
+
+/**
+ * @brief True when every record has gone to the UART; direct Serial3
+ * writers wait for this.
+ */
+bool logIdle();
+
+// The level test is a constant: the call and its PSTR vanish when false.
+// Tags are pasted right away in LOG_xx: ADC is also a register macro.
+#define LOG_AT(level, tagLevel, tagId, fmt, ...) \
+	do { \
+		if ((level) <= LOG_LEVEL && (level) <= (tagLevel)) \
+			logWrite((level), (tagId), PSTR(fmt), ##__VA_ARGS__); \
+	} while (0)
+
+// Disabled levels still see their arguments (no unused warnings), but
+// the constant test drops them before code generation.
+#define LOG_ERROR(tag, fmt, ...) LOG_AT(LOG_LEVEL_ERROR, LOG_LEVEL_##tag, LOG_TAG_##tag, fmt, ##__VA_ARGS__)
+#define LOG_WARN(tag, fmt, ...)  LOG_AT(LOG_LEVEL_WARN, LOG_LEVEL_##tag, LOG_TAG_##tag, fmt, ##__VA_ARGS__)
+#define LOG_INFO(tag, fmt, ...)  LOG_AT(LOG_LEVEL_INFO, LOG_LEVEL_##tag, LOG_TAG_##tag, fmt, ##__VA_ARGS__)
+#define LOG_DEBUG(tag, fmt, ...) LOG_AT(LOG_LEVEL_DEBUG, LOG_LEVEL_##tag, LOG_TAG_##tag, fmt, ##__VA_ARGS__)
+
+#endif /* LOG_H_ */
@@ -4,8 +4,8 @@
 	  
 int main(void) {
 	
-	Board_Init();       // Set up GPIOs, peripherals
-	scheduler.begin();  // Add tasks and start scheduler
+	Board_Init();       // Set up GPIOs, queue peripheral bring-up
+	scheduler.begin();  // Add tasks and start scheduler (only place it is called)
 
 	while (1) {
 		scheduler.run();  // Run ready tasks in priority order
@@ -0,0 +1,86 @@
+#include "metrics.h"
+#include "serial.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <stdlib.h>
+
+uint32_t metricValues[METRIC_COUNT];
+
+// Names in flash: one string per metric plus a table of pointers to them
+#define METRIC_NAME(id, name, kind) static const char metricName_##id[] PROGMEM = name;
+METRICS_LIST(METRIC_NAME)
+#undef METRIC_NAME
+
+static const char* const metricNames[METRIC_COUNT] PROGMEM = {
+#define METRIC_NAME_PTR(id, name, kind) metricName_##id,
+	METRICS_LIST(METRIC_NAME_PTR)
+#undef METRIC_NAME_PTR
+};
+
+static const uint8_t metricKinds[METRIC_COUNT] PROGMEM = {
+#define METRIC_KIND(id, name, kind) kind,
+	METRICS_LIST(METRIC_KIND)
+#undef METRIC_KIND
+};
+
+static uint8_t dumpIndex = METRIC_COUNT;   // METRIC_COUNT = no dump running
+static bool dumpHeader = false;
+
+uint32_t metricGet(uint8_t id) {
+	if (id >= METRIC_COUNT) return 0;
+
+	uint8_t sreg = SREG;
+	cli();
+	uint32_t value = metricValues[id];
+	SREG = sreg;
+	return value;
+}
+
+void metricName(uint8_t id, char* buffer, uint8_t size) {
+	if (!buffer || size == 0) return;
+	buffer[0] = '\0';
+	if (id >= METRIC_COUNT) return;
+
+	const char* p = (const char*)pgm_read_ptr(&metricNames[id]);
+	uint8_t i = 0;
+	while (i < size - 1) {
+		char c = pgm_read_byte(p + i);
+		if (c == '\0') break;
+		buffer[i++] = c;
+	}
+	buffer[i] = '\0';
+}
+
+uint8_t metricKind(uint8_t id) {
+	if (id >= METRIC_COUNT) return METRIC_COUNTER;
+	return pgm_read_byte(&metricKinds[id]);
+}
+
+void metricsDumpBegin() {
+	dumpIndex = 0;
+	dumpHeader = true;
+}
+
+bool metricsDumpStep(SerialClass& port, uint8_t maxLines) {
+	if (dumpIndex >= METRIC_COUNT) return false;
+
+	if (dumpHeader) {
+		port.print("METRICS "); port.println(METRIC_COUNT);
+		dumpHeader = false;
+	}
+
+	char name[24];
+	char value[11];
+	while (dumpIndex < METRIC_COUNT && maxLines--) {
+		metricName(dumpIndex, name, sizeof(name));
+		ultoa(metricGet(dumpIndex), value, 10);
+		port.print(metricKind(dumpIndex) == METRIC_GAUGE ? "G " : "C ");
+		port.print(name); port.print(" "); port.println(value);
+		dumpIndex++;
+	}
+
+	if (dumpIndex < METRIC_COUNT) return true;
+	port.println("METRICS END");
+	return false;
+}
@@ -0,0 +1,79 @@
+#ifndef METRICS_H_
+#define METRICS_H_
+
+#include <stdint.h>
+
+/**
+ * @file metrics.h
+ * @brief Central registry of counters and gauges.
+ *
+ * Every metric is one line in METRICS_LIST: id, name (kept in flash) and
+ * kind. The list expands into the MetricId enum, the name table and the
+ * value array, so adding a metric is a single line here plus the
+ * METRIC_INC/SET/MAX call at the place that counts it.
+ *
+ * Values are 32-bit. An increment is a plain load/add/store on a fixed
+ * address (~14 cycles, no call); this is safe because each metric has
+ * exactly one writing context (a task or one ISR). Readers take a
+ * snapshot with interrupts off (metricGet()), so they never see a torn
+ * value.
+ *
+ * The console command 'M' prints "name value" lines, a few per run of
+ * consoleTask.
+ */
+
+#define METRIC_COUNTER 0   // Only goes up
+#define METRIC_GAUGE   1   // Current or peak value
+
+//      id                    name                   kind            writer
+#define METRICS_LIST(X) \
+	X(UART_TX_BYTES,      "uart.tx_bytes",       METRIC_COUNTER) /* tasks    */ \
+	X(UART_RX_BYTES,      "uart.rx_bytes",       METRIC_COUNTER) /* tasks    */ \
+	X(SCHED_DISPATCHES,   "sched.dispatches",    METRIC_COUNTER) /* run()    */ \
+	X(SCHED_OVERRUNS,     "sched.overruns",      METRIC_COUNTER) /* Timer0   */ \
+	X(ADC_SCANS,          "adc.scans",           METRIC_COUNTER) /* ADC_vect */ \
+	X(ADC_STREAM_DROPS,   "adc.stream_drops",    METRIC_COUNTER) /* ADC_vect */ \
+	X(LCD_BYTES,          "lcd.bytes",           METRIC_COUNTER) /* tasks    */ \
+	X(LCD_QUEUE_DROPS,    "lcd.queue_drops",     METRIC_COUNTER) /* tasks    */ \
+	X(LCD_QUEUE_PEAK,     "lcd.queue_peak",      METRIC_GAUGE)   /* tasks    */ \
+	X(CONFIG_WRITES,      "config.eeprom_writes", METRIC_COUNTER) /* tasks   */ \
+	X(LOG_DROPS,          "log.drops",           METRIC_COUNTER) /* tasks    */
+
+enum MetricId {
+#define METRIC_ENUM(id, name, kind) METRIC_##id,
+	METRICS_LIST(METRIC_ENUM)
+#undef METRIC_ENUM
+	METRIC_COUNT
+};
+
+extern uint32_t metricValues[METRIC_COUNT];
+
+#define METRIC_INC(id)         (metricValues[METRIC_##id]++)
+#define METRIC_ADD(id, n)      (metricValues[METRIC_##id] += (n))
+#define METRIC_SET(id, v)      (metricValues[METRIC_##id] = (v))
+#define METRIC_MAX(id, v)      do { if ((uint32_t)(v) > metricValues[METRIC_##id]) \
+                                        metricValues[METRIC_##id] = (v); } while (0)
+
+class SerialClass;
+
+/**
+ * @brief Atomic snapshot of one metric.
+ */
+uint32_t metricGet(uint8_t id);
+
+/**
+ * @brief Copies the name (from flash) into buffer, NUL-terminated.
+ */
+void metricName(uint8_t id, char* buffer, uint8_t size);
+
+uint8_t metricKind(uint8_t id);
+
+void metricsDumpBegin();
+
+/**
+ * @brief Prints up to maxLines "name value" lines to port.
+ * @return true while more lines are left
+ */
+bool metricsDumpStep(SerialClass& port, uint8_t maxLines);
+
+#endif /* METRICS_H_ */
@@ -0,0 +1,91 @@
+#ifndef POSTMORTEM_H_
+#define POSTMORTEM_H_
+
+#include <stdint.h>
+
+/**
+ * @file postmortem.h
+ * @brief Event log that survives warm resets.
+ *
+ * The log lives in .noinit, so a watchdog, brown-out or external reset
+ * leaves it intact. It holds the last PM_ENTRIES significant events:
+ * resets (MCUSR and the watchdog diagnosis), task overruns and watchdog
+ * causes, and buffer overflows. A repeat of the newest event only bumps
+ * its repeat count, so an overflow storm takes a single entry.
+ *
+ * Validation: the header carries a magic word and a CRC-8, and every
+ * entry its own CRC-8. After power-on (random RAM) or a reset in the
+ * middle of a write only the damaged part is dropped. log() runs with
+ * interrupts off for ~250 cycles (~16 us): the entry (10 bytes) and the
+ * header (4 bytes) are sealed with a table CRC at ~8 cycles per byte.
+ * It is ISR-safe; hot paths (ADC_vect, LCD enqueue) only call it on an
+ * overflow.
+ *
+ * begin() runs with the watchdog at boot and appends the reset entry;
+ * the bring-up then sends the whole log through the log sink, one record
+ * at a time (reportStep()), without holding up the UART tasks.
+ */
+
+#define PM_ENTRIES  16
+
+// Event codes (arg / value meaning)
+#define PM_RESET          1   // MCUSR / watchdog cause << 8 | task
+#define PM_WDT_CAUSE      2   // WDT_CAUSE_xx / task slot
+#define PM_TASK_OVERRUN   3   // task slot / runtime budget (ms)
+#define PM_OVERFLOW       4   // PM_SRC_xx / 0
+
+// Buffers reporting overflows
+#define PM_SRC_ADC_STREAM   1
+#define PM_SRC_ADC_WINDOW   2
+#define PM_SRC_LCD_QUEUE    3
+
+struct PmEntry {
+	uint32_t tick;     // Scheduler tick of the last occurrence
+	uint8_t  code;     // PM_xx, 0 = empty or damaged
+	uint8_t  arg;
+	uint16_t value;
+	uint16_t repeat;   // Occurrences in a row (saturates)
+	uint8_t  crc;      // CRC-8 over the fields above
+};
+
+struct PmHeader {
+	uint16_t magic;
+	uint8_t  head;     // Next entry to write
+	uint8_t  count;    // Valid entries (up to PM_ENTRIES)
+	uint8_t  crc;      // CRC-8 over the fields above
+};
+
+extern PmHeader pmHeader;
+extern PmEntry pmEntries[PM_ENTRIES];
+
+class PostMortem {
+	public:
+	/**
+	 * @brief Validates the log (clears it if damaged) and records this reset.
+	 */
+	void begin(uint8_t mcusr, uint8_t wdtCause, uint8_t wdtTask);
+
+	/**
+	 * @brief Appends an event, or counts a repeat of the newest one. ISR-safe.
+	 */
+	void log(uint8_t code, uint8_t arg, uint16_t value = 0);
+
+	void clear();
+
+	/**
+	 * @brief Logs the next line, oldest first, once the log ring has
+	 * drained. Never waits for the UART.
+	 * @return true while more lines are left
+	 */
+	bool reportStep();
+
+	private:
+	uint8_t _reportFirst = 0;      // Oldest entry when the report started
+	uint8_t _reportCount = 0;      // Entries in the log at that time
+	uint8_t _reportIndex = 0;      // Entries printed so far
+	bool _reportStarted = false;
+};
+
+extern PostMortem postmortem;
+
+#endif /* POSTMORTEM_H_ */
@@ -0,0 +1,83 @@
+#include "trace.h"
+#include "serial.h"
+#include <stdlib.h>
+
+TraceRecord traceBuffer[TRACE_SIZE];
+uint8_t traceHead = 0;
+volatile uint8_t traceMask = TRACE_CAT_DEFAULT;
+
+static bool dumpActive = false;
+static bool dumpHeader = false;     // "TRACE n" line still to print
+static uint8_t dumpIndex = 0;       // Next record to print
+static uint8_t dumpLeft = 0;        // Records still to print
+static uint8_t dumpSavedMask = 0;
+
+void traceSetMask(uint8_t categories) {
+	if (dumpActive) dumpSavedMask = categories;  // Applies after the dump
+	else traceMask = categories;
+}
+
+void traceClear() {
+	uint8_t sreg = SREG;
+	cli();
+	traceHead = 0;
+	for (uint8_t i = 0; i < TRACE_SIZE; ++i) {
+		traceBuffer[i].id = 0;      // id 0 = never written
+	}
+	SREG = sreg;
+}
+
+void traceDumpBegin() {
+	if (dumpActive) return;
+
+	uint8_t sreg = SREG;
+	cli();
+	dumpSavedMask = traceMask;
+	traceMask = 0;                   // Freeze: the dump itself is not traced
+	SREG = sreg;
+
+	// The slot at head is only used once the ring has wrapped
+	bool wrapped = traceBuffer[traceHead].id != 0;
+	dumpIndex = wrapped ? traceHead : 0;
+	dumpLeft = wrapped ? TRACE_SIZE : traceHead;
+	dumpHeader = true;
+	dumpActive = true;
+}
+
+static void printHex(SerialClass& port, uint16_t value) {
+	char buffer[5];
+	utoa(value, buffer, 16);
+	port.print(buffer);
+}
+
+/**
+ * The ring is cleared after the dump, so the next dump only shows what
+ * happened since.
+ */
+bool traceDumpStep(SerialClass& port, uint8_t maxRecords) {
+	if (!dumpActive) return false;
+
+	if (dumpHeader) {
+		port.print("TRACE "); port.println(dumpLeft);
+		dumpHeader = false;
+	}
+
+	while (dumpLeft && maxRecords--) {
+		const TraceRecord& r = traceBuffer[dumpIndex];
+		port.print("T ");
+		printHex(port, r.tick); port.print(" ");
+		printHex(port, r.sub); port.print(" ");
+		printHex(port, r.id); port.print(" ");
+		printHex(port, r.arg); port.println("");
+		dumpIndex = (dumpIndex + 1) & (TRACE_SIZE - 1);
+		dumpLeft--;
+	}
+
+	if (dumpLeft) return true;
+
+	port.println("TRACE END");
+	traceClear();
+	traceMask = dumpSavedMask;
+	dumpActive = false;
+	return false;
+}
@@ -0,0 +1,126 @@
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <stdint.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+/**
+ * @file trace.h
+ * @brief Binary event trace in a RAM ring buffer.
+ *
+ * TRACE(id, arg) stores one 5-byte record in ~25 cycles and never prints:
+ *
+ *     tick(2)  low 16 bits of the 1 ms scheduler tick
+ *     sub(1)   TCNT0 at the event, 4 us per count
+ *     id(1)    TRACE_xx event
+ *     arg(1)   task slot, ISR number, UART byte, ADC channel ...
+ *
+ * The ring keeps the newest TRACE_SIZE records. Typing 'T' on the console
+ * freezes it and dumps it as text lines ("T tick sub id arg", hex), a few
+ * records per consoleTask run. Tools/trace2json.py turns a captured dump
+ * into a Chrome/Perfetto JSON timeline (chrome://tracing, ui.perfetto.dev).
+ *
+ * traceSetMask() selects categories at run time; TRACE_ENABLED 0 removes
+ * all hooks at compile time.
+ */
+
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 1
+#endif
+
+#define TRACE_SIZE  128    // Records (power of two), 5 bytes each
+
+// Event IDs (keep in sync with Tools/trace2json.py)
+#define TRACE_TASK_BEGIN   0x01  // arg = task slot
+#define TRACE_TASK_END     0x02  // arg = task slot
+#define TRACE_ISR_ENTER    0x03  // arg = TRACE_ISR_xx
+#define TRACE_ISR_EXIT     0x04  // arg = TRACE_ISR_xx
+#define TRACE_UART_TX      0x05  // arg = byte
+#define TRACE_UART_RX      0x06  // arg = byte
+#define TRACE_ADC_DONE     0x07  // arg = channel (final scan result)
+#define TRACE_MARK         0x08  // arg = user value
+
+#define TRACE_ISR_TIMER0   0
+#define TRACE_ISR_ADC      1
+#define TRACE_ISR_WDT      2
+
+// Categories for traceSetMask()
+#define TRACE_CAT_TASK     (1 << 0)
+#define TRACE_CAT_ISR      (1 << 1)
+#define TRACE_CAT_UART     (1 << 2)
+#define TRACE_CAT_ADC      (1 << 3)
+#define TRACE_CAT_MARK     (1 << 4)
+#define TRACE_CAT_ALL      0xFF
+
+// ISR and ADC events come at several per ms with the scan running, and
+// UART events one per byte (a single log line is ~40 records); any of
+// them would push everything else out of the ring. Enable when needed.
+#define TRACE_CAT_DEFAULT  (TRACE_CAT_TASK | TRACE_CAT_MARK)
+
+struct TraceRecord {
+	uint16_t tick;
+	uint8_t  sub;
+	uint8_t  id;
+	uint8_t  arg;
+};
+
+class SerialClass;
+
+extern TraceRecord traceBuffer[TRACE_SIZE];
+extern uint8_t traceHead;
+extern volatile uint8_t traceMask;
+extern volatile uint32_t schedulerTickCount;
+
+/**
+ * @brief Stores one record if its category is enabled. ISR-safe.
+ */
+static inline void traceEvent(uint8_t category, uint8_t id, uint8_t arg) {
+	if (!(traceMask & category)) return;
+
+	uint8_t sreg = SREG;
+	cli();
+	TraceRecord& r = traceBuffer[traceHead];
+	r.tick = (uint16_t)schedulerTickCount;
+	r.sub = TCNT0;
+	r.id = id;
+	r.arg = arg;
+	traceHead = (traceHead + 1) & (TRACE_SIZE - 1);
+	SREG = sreg;
+}
+
+void traceSetMask(uint8_t categories);   // TRACE_CAT_xx, 0 = off
+void traceClear();
+
+/**
+ * @brief Starts a dump: recording stops until the dump has finished.
+ */
+void traceDumpBegin();
+
+/**
+ * @brief Prints up to maxRecords dump lines to port.
+ * @return true while more lines are left
+ */
+bool traceDumpStep(SerialClass& port, uint8_t maxRecords);
+
+#if TRACE_ENABLED
+#define TRACE_TASK_BEGIN_EVT(slot)  traceEvent(TRACE_CAT_TASK, TRACE_TASK_BEGIN, (slot))
+#define TRACE_TASK_END_EVT(slot)    traceEvent(TRACE_CAT_TASK, TRACE_TASK_END, (slot))
+#define TRACE_ISR_ENTER_EVT(n)      traceEvent(TRACE_CAT_ISR, TRACE_ISR_ENTER, (n))
+#define TRACE_ISR_EXIT_EVT(n)       traceEvent(TRACE_CAT_ISR, TRACE_ISR_EXIT, (n))
+#define TRACE_UART_TX_EVT(b)        traceEvent(TRACE_CAT_UART, TRACE_UART_TX, (b))
+#define TRACE_UART_RX_EVT(b)        traceEvent(TRACE_CAT_UART, TRACE_UART_RX, (b))
+#define TRACE_ADC_DONE_EVT(ch)      traceEvent(TRACE_CAT_ADC, TRACE_ADC_DONE, (ch))
+#define TRACE_MARK_EVT(v)           traceEvent(TRACE_CAT_MARK, TRACE_MARK, (v))
+#else
+#define TRACE_TASK_BEGIN_EVT(slot)
+#define TRACE_TASK_END_EVT(slot)
+#define TRACE_ISR_ENTER_EVT(n)
+#define TRACE_ISR_EXIT_EVT(n)
+#define TRACE_UART_TX_EVT(b)
+#define TRACE_UART_RX_EVT(b)
+#define TRACE_ADC_DONE_EVT(ch)
+#define TRACE_MARK_EVT(v)
+#endif
+
+#endif /* TRACE_H_ */
@@ -1,4 +1,21 @@
 #include "adc.h"
+#include "adc_filter.h"
+#include "adc_window.h"
+#include "adc_stats.h"
+#include "serial.h"
+#include "trace.h"
+#include "postmortem.h"
+#include "metrics.h"
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+// Timer0 runs the 1 ms scheduler tick at prescaler 64 (see Scheduler::init)
+#define ADC_SLEEP_TIMER0_PRESCALER  64
+#define ADC_SLEEP_TIMER0_MARGIN     3    // Counts for the wake-up and ADC_vect
 
 /*
  * ============================================================
@@ -69,25 +86,13 @@
  */
 
 // ========================
-// ADC Initialization
+// Prescaler Lookup
 // ========================
 /**
- * Initializes the ADC with selected mode (single or free-running)
- * and desired ADC clock frequency. Ensures valid resolution and
- * selects a suitable prescaler automatically.
+ * Returns the ADPS2:0 bits of the smallest prescaler whose ADC clock
+ * does not exceed adcClockHz (128 if none does).
  */
-void AVR_ADC::init(uint8_t mode, uint32_t adcClockHz) {
-    _mode = mode;
-
-    // Clamp requested ADC clock frequency for 10-bit accuracy
-    if (_resolution == 10) {
-        if (adcClockHz < 50000)  adcClockHz = 50000;
-        if (adcClockHz > 200000) adcClockHz = 200000;
-    }
-
-    const uint32_t F_CPU_HZ = 16000000UL; // Main clock
-    uint8_t prescalerBits = 0b111;        // Default: 128
-
+static uint8_t prescalerBitsFor(uint32_t adcClockHz) {
     // Mapping between ADC prescaler values and register bits
     struct PrescalerEntry {
         uint8_t bits;   // Bit pattern for ADPS2:0
@@ -104,27 +109,63 @@ void AVR_ADC::init(uint8_t mode, uint32_t adcClockHz) {
         {0b111, 128}
     };
 
-    // Select the smallest prescaler that produces ADC_CLK ? adcClockHz
+    // Select the smallest prescaler that produces ADC_CLK <= adcClockHz
     for (uint8_t i = 0; i < sizeof(table)/sizeof(table[0]); ++i) {
-        if ((F_CPU_HZ / table[i].value) <= adcClockHz) {
-            prescalerBits = table[i].bits;
-            break;
+        if ((F_CPU / table[i].value) <= adcClockHz) {
+            return table[i].bits;
         }
     }
+    return 0b111;                          // Default: 128
+}
+
+// ========================
+// ADC Initialization
+// ========================
+/**
+ * Initializes the ADC with selected mode (single or free-running)
+ * and desired ADC clock frequency. Ensures valid resolution and
+ * selects a suitable prescaler automatically.
+ */
+void AVR_ADC::init(uint8_t mode, uint32_t adcClockHz) {
+    _mode = mode;
+
+    // Clamp requested ADC clock frequency for 10-bit accuracy
+    if (_resolution >= 10) {
+        if (adcClockHz < 50000)  adcClockHz = 50000;
+        if (adcClockHz > 200000) adcClockHz = 200000;
+    }
+
+    uint8_t prescalerBits = prescalerBitsFor(adcClockHz);
+    _prescalerBits = prescalerBits;
 
     // Enable ADC, set calculated prescaler
     ADCSRA = (1 << ADEN); // Enable ADC
     ADCSRA &= ~((1 << ADPS2) | (1 << ADPS1) | (1 << ADPS0)); // Clear prescaler
     ADCSRA |= prescalerBits; // Set prescaler bits
 
-    // Set reference voltage to AVcc (default)
-    ADMUX = (1 << REFS0);
+    // Reference from setReference() (default AVcc), mux not yet routed
+    ADMUX = _refBits;
+    _lastChannel = 0xFF;
+
+    // Settling discards depend on the conversion time
+    for (uint8_t ch = 0; ch < ADC_NUM_CHANNELS; ++ch) {
+        planChannel(ch);
+    }
 
     // Free-running mode: auto-trigger enabled, start conversion
     if (_mode == ADC_MODE_FREE) {
         ADCSRA |= (1 << ADATE);  // Auto Trigger Enable
         ADCSRB &= ~((1 << ADTS2) | (1 << ADTS1) | (1 << ADTS0));  // Trigger Source: Free Running
         ADCSRA |= (1 << ADSC);   // Start first conversion
+    } else if (_mode == ADC_MODE_SCAN) {
+        // Manual trigger from ADC_vect; conversions start with startScan()
+        ADCSRA &= ~(1 << ADATE);
+        ADCSRA |= (1 << ADIE);   // Conversion complete interrupt
+    } else if (_mode == ADC_MODE_TIMER) {
+        // Auto-trigger on Timer1 Compare Match B; Timer1 starts in startStream()
+        ADCSRB = (ADCSRB & ~((1 << ADTS2) | (1 << ADTS1) | (1 << ADTS0)))
+               | (1 << ADTS2) | (1 << ADTS0);
+        ADCSRA |= (1 << ADATE) | (1 << ADIE);
     } else {
         // Single conversion mode
         ADCSRA &= ~(1 << ADATE); // Manual trigger
@@ -134,34 +175,55 @@ void AVR_ADC::init(uint8_t mode, uint32_t adcClockHz) {
 // ========================
 // Set Reference Voltage
 // ========================
+/**
+ * REFS1:0 pattern for a reference mode (ATmega2560 encoding).
+ */
+static uint8_t referenceBits(uint8_t mode) {
+    switch (mode) {
+        case MODE_EXVREF:   return 0;                             // External reference (AREF pin)
+        case MODE_AVCC:     return (1 << REFS0);                  // AVcc with capacitor
+        case MODE_INT_1V1:  return (1 << REFS1);                  // Internal 1.1V
+        case MODE_INT_2V56: return (1 << REFS1) | (1 << REFS0);   // Internal 2.56V
+        default:            return (1 << REFS0);                  // Default: AVcc
+    }
+}
+
 /**
  * Sets the ADC reference voltage source.
- * Options: External, AVcc, Internal 1.1V, Internal 2.56V (fallback).
+ * Options: External, AVcc, Internal 1.1V, Internal 2.56V.
+ *
+ * Single-shot reads and the scanner switch ADMUX per channel (see
+ * routeChannel()), which also discards conversions while AREF settles.
+ * Free-running and stream modes take the new reference at once.
  */
 void AVR_ADC::setReference(uint8_t mode) {
-    // Clear previous reference bits
-    ADMUX &= ~((1 << REFS1) | (1 << REFS0));
+    uint8_t sreg = SREG;
+    cli();
 
-    // Set reference based on mode
-    switch (mode) {
-        case MODE_EXVREF:  break; // External reference (AREF pin)
-        case MODE_AVCC:    ADMUX |= (1 << REFS0); break; // AVcc with capacitor
-        case MODE_INT_1V1: ADMUX |= (1 << REFS1) | (1 << REFS0); break; // Internal 1.1V
-        case MODE_INT_2V56: ADMUX |= (1 << REFS0); break; // (Fallback, only REFS0)
-        default:           ADMUX |= (1 << REFS0); break; // Default: AVcc
+    _refBits = referenceBits(mode);
+    if (_mode == ADC_MODE_FREE || _mode == ADC_MODE_TIMER) {
+        ADMUX = (ADMUX & ~((1 << REFS1) | (1 << REFS0))) | _refBits;
     }
+
+    SREG = sreg;
 }
 
 // ========================
 // Set and Get Resolution
 // ========================
 /**
- * Sets resolution to 810 bits (10-bit is native; 8/9-bit via shift).
+ * Sets resolution to 813 bits (10-bit is native; 8/9-bit via shift,
+ * 1113-bit via oversampling and decimation).
+ * Channels without their own setting follow this value.
  */
 void AVR_ADC::setResolution(uint8_t bits) {
     if (bits < 8) bits = 8;
-    if (bits > 10) bits = 10;
+    if (bits > 13) bits = 13;
     _resolution = bits;
+
+    for (uint8_t ch = 0; ch < ADC_NUM_CHANNELS; ++ch) {
+        planChannel(ch);
+    }
 }
 
 /**
@@ -171,6 +233,122 @@ uint8_t AVR_ADC::getResolution() {
     return _resolution;
 }
 
+/**
+ * Overrides the resolution of one channel (813 bits, 0 = follow
+ * setResolution()). Applies to analogRead() and the background scanner.
+ */
+void AVR_ADC::setChannelResolution(uint8_t channel, uint8_t bits) {
+    if (channel > 15) return;
+    if (bits != 0 && bits < 8) bits = 8;
+    if (bits > 13) bits = 13;
+
+    _chResolution[channel] = bits;
+    planChannel(channel);
+}
+
+uint8_t AVR_ADC::getChannelResolution(uint8_t channel) {
+    if (channel > 15) return _resolution;
+    return _chResolution[channel] ? _chResolution[channel] : _resolution;
+}
+
+// ========================
+// Per-Channel Conversion Settings
+// ========================
+void AVR_ADC::setChannelDiscard(uint8_t channel, uint8_t count) {
+    if (channel > 15) return;
+    if (count > 15) count = 15;
+    _chDiscard[channel] = count;
+}
+
+void AVR_ADC::setChannelClock(uint8_t channel, uint32_t adcClockHz) {
+    if (channel > 15) return;
+    _chPrescaler[channel] = adcClockHz ? prescalerBitsFor(adcClockHz) : 0;
+    planChannel(channel);
+}
+
+void AVR_ADC::setChannelReference(uint8_t channel, uint8_t mode) {
+    if (channel > 15) return;
+    _chReference[channel] = mode;
+}
+
+uint8_t AVR_ADC::referenceBitsFor(uint8_t channel) {
+    uint8_t mode = _chReference[channel];
+    return (mode == ADC_REF_GLOBAL) ? _refBits : referenceBits(mode);
+}
+
+/**
+ * Points the ADC at a channel: reference, clock, then mux.
+ * Returns the number of conversions to throw away before a result can
+ * be trusted: the channel's discard count after a mux switch, or the
+ * AREF settling time after a reference switch (whichever is longer).
+ * Nothing is touched, and nothing discarded, if the ADC already points
+ * at the channel.
+ */
+uint16_t AVR_ADC::routeChannel(uint8_t channel) {
+    const uint8_t refMask = (1 << REFS1) | (1 << REFS0);
+    const uint8_t adpsMask = (1 << ADPS2) | (1 << ADPS1) | (1 << ADPS0);
+    uint16_t discard = 0;
+
+    uint8_t ref = referenceBitsFor(channel);
+    if ((ADMUX & refMask) != ref) {
+        ADMUX = (ADMUX & ~refMask) | ref;
+        discard = _chRefSettle[channel];
+    }
+
+    uint8_t adps = _chPrescaler[channel] ? _chPrescaler[channel] : _prescalerBits;
+    if ((ADCSRA & adpsMask) != adps) {
+        ADCSRA = (ADCSRA & ~adpsMask) | adps;
+    }
+
+    if (channel != _lastChannel) {
+        selectChannel(channel);
+        if (discard < _chDiscard[channel]) discard = _chDiscard[channel];
+    }
+    return discard;
+}
+
+/**
+ * Derives the scanner's sample count and result shift for a channel.
+ *
+ * Above 10 bits every extra bit costs 4x the samples (4^n samples, sum
+ * shifted right by n). Up to 10 bits the scan oversampling is averaged
+ * and the result scaled down. Both cases reduce to one shift in the ISR.
+ */
+void AVR_ADC::planChannel(uint8_t channel) {
+    uint8_t bits = getChannelResolution(channel);
+    uint8_t log2Samples, shift;
+
+    if (bits > 10) {
+        log2Samples = 2 * (bits - 10);
+        shift = bits - 10;
+    } else {
+        log2Samples = _scanOversampleLog2;
+        shift = _scanOversampleLog2 + (10 - bits);
+    }
+
+    // Conversions covering ADC_REF_SETTLE_US at this channel's ADC clock
+    uint8_t adps = _chPrescaler[channel] ? _chPrescaler[channel] : _prescalerBits;
+    uint32_t conversionCycles = 13UL << (adps ? adps : 1);
+    uint32_t settle = (ADC_REF_SETTLE_US * (F_CPU / 1000000UL)) / conversionCycles + 1;
+    if (settle > 0xFFFF) settle = 0xFFFF;
+
+    uint8_t sreg = SREG;
+    cli();
+    _chSamples[channel] = 1 << log2Samples;
+    _chShift[channel] = shift;
+    _chRefSettle[channel] = settle;
+    SREG = sreg;
+}
+
+/**
+ * Scales a native 10-bit result to the global resolution. Paths that
+ * cannot oversample (free-running, stream) only shift above 10 bits.
+ */
+uint16_t AVR_ADC::scaleRaw(uint16_t raw) {
+    if (_resolution >= 10) return raw << (_resolution - 10);
+    return raw >> (10 - _resolution);
+}
+
 // ========================
 // Single ADC Read
 // ========================
@@ -179,19 +357,169 @@ uint8_t AVR_ADC::getResolution() {
  * Valid only in single conversion mode.
  */
 uint16_t AVR_ADC::analogRead(uint8_t channel) {
-    if (_mode != ADC_MODE_SINGLE || channel > 15) return 0;
+    if (!canReadBlocking() || channel > 15) return 0;
+
+    uint8_t bits = getChannelResolution(channel);
+    if (bits > 10) return analogReadDecimated(channel, bits);
 
-    // Configure channel: handle MUX5 for channels > 7
-    ADCSRB &= ~(1 << MUX5);                        // Clear MUX5
-    ADMUX = (ADMUX & 0xF0) | (channel & 0x0F);     // Set MUX0MUX3
-    if (channel > 7) ADCSRB |= (1 << MUX5);        // Set MUX5 if needed
+    return readRaw(channel) >> (10 - bits);
+}
+
+/**
+ * Blocking reads are allowed in single mode and while the scanner is stopped.
+ */
+bool AVR_ADC::canReadBlocking() {
+    return _mode == ADC_MODE_SINGLE || (_mode == ADC_MODE_SCAN && !_scanning);
+}
 
-    // Start conversion and wait for completion
-    ADCSRA |= (1 << ADSC);
-    while (ADCSRA & (1 << ADSC)); // Wait until ADSC clears
+/**
+ * One native 10-bit conversion on the given channel.
+ */
+uint16_t AVR_ADC::readRaw(uint8_t channel, bool noiseReduced) {
+    uint16_t discard = routeChannel(channel);
 
-    uint16_t raw = ADCW;
-    return (_resolution == 10) ? raw : (raw >> (10 - _resolution));
+    // Settling conversions first, then the one that counts
+    do {
+        // Start conversion (by sleeping, or via ADSC) and wait for completion
+        if (!noiseReduced || !sleepConvert()) {
+            ADCSRA |= (1 << ADSC);
+        }
+        while (ADCSRA & (1 << ADSC)); // Wait until ADSC clears
+    } while (discard--);
+
+    return ADCW;
+}
+
+// ========================
+// Noise Reduction Sleep
+// ========================
+/**
+ * Reads like analogRead(), with every conversion done in ADC Noise
+ * Reduction sleep. Resolutions above 10 bits still decimate.
+ */
+uint16_t AVR_ADC::analogReadNoiseReduced(uint8_t channel) {
+    if (!canReadBlocking() || channel > 15) return 0;
+
+    uint8_t bits = getChannelResolution(channel);
+    if (bits > 10) return analogReadDecimated(channel, bits, true);
+
+    return readRaw(channel, true) >> (10 - bits);
+}
+
+/**
+ * Starts one conversion by entering SLEEP_MODE_ADC.
+ * Returns false, with nothing started, when sleeping is not safe.
+ *
+ * clkIO is halted while asleep, which freezes Timer0 and the USARTs:
+ *   - a UART still transmitting would garble its byte, so refuse
+ *   - Timer0 must not reach OCR0A during the halt; if it is too close,
+ *     wait for the tick (at most ~120 us) before going to sleep
+ *   - on wake-up the halted counts are added back to TCNT0
+ * The compensation is exact to one count (4 us) when ADC_vect is the wake
+ * source. An interrupt that was already pending wakes the core at once;
+ * then the conversion finishes awake and nothing is added.
+ */
+bool AVR_ADC::sleepConvert() {
+    uint8_t sreg = SREG;
+    if (!(sreg & (1 << SREG_I))) return false;           // Nothing could wake us
+
+    if (Serial.txBusy() || Serial1.txBusy() || Serial2.txBusy() || Serial3.txBusy()) {
+        _sleepFallbacks++;
+        return false;
+    }
+
+    // A conversion takes 13 ADC clocks = 13 * prescaler CPU cycles
+    uint8_t adps = ADCSRA & ((1 << ADPS2) | (1 << ADPS1) | (1 << ADPS0));
+    uint16_t cycles = 13U << (adps ? adps : 1);
+    uint8_t halt = (cycles + ADC_SLEEP_TIMER0_PRESCALER / 2) / ADC_SLEEP_TIMER0_PRESCALER;
+
+    for (;;) {
+        cli();
+        if (!(TIFR0 & (1 << OCF0A)) &&
+            (uint16_t)TCNT0 + halt + ADC_SLEEP_TIMER0_MARGIN < OCR0A) break;
+        SREG = sreg;                                       // Let the tick ISR run
+    }
+
+    uint8_t adie = ADCSRA & (1 << ADIE);
+    ADCSRA |= (1 << ADIE);                                 // ADC_vect is the wake source
+
+    set_sleep_mode(SLEEP_MODE_ADC);
+    sleep_enable();
+    sei();                                                 // Takes effect after the next instruction
+    sleep_cpu();                                           // Conversion starts here
+    sleep_disable();
+
+    cli();
+    if (!(ADCSRA & (1 << ADSC))) {
+        TCNT0 += halt;                                     // Woken by ADC_vect
+    }
+    if (!adie) ADCSRA &= ~(1 << ADIE);
+    SREG = sreg;
+    return true;
+}
+
+void AVR_ADC::setNoiseReduction(bool enable) {
+    uint8_t sreg = SREG;
+    cli();
+    _noiseReduction = enable;
+    if (!enable && _startPending) {
+        _startPending = false;
+        ADCSRA |= (1 << ADSC);                             // Hand the scan back to ADC_vect
+    }
+    SREG = sreg;
+}
+
+/**
+ * Starts the scan conversion that ADC_vect left pending. Runs in task
+ * context, so the sleep never nests inside another interrupt.
+ */
+void AVR_ADC::idle() {
+    if (!_startPending) return;
+    _startPending = false;
+    if (!_scanning) return;
+
+    if (!sleepConvert()) ADCSRA |= (1 << ADSC);
+}
+
+uint16_t AVR_ADC::sleepFallbacks() {
+    return _sleepFallbacks;
+}
+
+/**
+ * Next scan conversion: immediately, or from idle() when sleeping.
+ */
+void AVR_ADC::startNext() {
+    if (_noiseReduction) _startPending = true;
+    else                 ADCSRA |= (1 << ADSC);
+}
+
+// ========================
+// Oversample and Decimate
+// ========================
+/**
+ * Reads 4^n samples and shifts the 32-bit sum right by n, giving
+ * 10 + n effective bits when the input carries at least 1 LSB of noise.
+ *
+ * | bits | samples | time @125 kHz |
+ * |------|---------|---------------|
+ * |  10  |    1    |    104 us     |
+ * |  11  |    4    |    416 us     |
+ * |  12  |   16    |    1.7 ms     |
+ * |  13  |   64    |    6.7 ms     |
+ */
+uint16_t AVR_ADC::analogReadDecimated(uint8_t channel, uint8_t bits, bool noiseReduced) {
+    if (!canReadBlocking() || channel > 15) return 0;
+    if (bits < 10) bits = 10;
+    if (bits > 13) bits = 13;
+
+    uint8_t n = bits - 10;
+    uint8_t samples = 1 << (2 * n);
+    uint32_t sum = 0;
+
+    for (uint8_t i = 0; i < samples; ++i) {
+        sum += readRaw(channel, noiseReduced);
+    }
+    return sum >> n;
 }
 
 // ========================
@@ -202,8 +530,7 @@ uint16_t AVR_ADC::analogRead(uint8_t channel) {
  * Only valid if ADC is running in free mode.
  */
 uint16_t AVR_ADC::readLatest() {
-    uint16_t raw = ADCW;
-    return (_resolution == 10) ? raw : (raw >> (10 - _resolution));
+    return scaleRaw(ADCW);
 }
 
 // ========================
@@ -244,6 +571,272 @@ void AVR_ADC::analogReadAllOversampled(uint8_t oversample, uint16_t* buffer) {
 	}
 }
 
+// ========================
+// Channel Selection
+// ========================
+/**
+ * Routes the multiplexer to a single-ended channel (0-15).
+ * ADC0-7 use MUX2:0 with MUX5 = 0, ADC8-15 the same bits with MUX5 = 1.
+ * MUX4:3 stay 0; setting them would select a differential pair.
+ */
+void AVR_ADC::selectChannel(uint8_t channel) {
+    ADMUX = (ADMUX & 0xE0) | (channel & 0x07);     // Keep REFS1:0 and ADLAR
+    if (channel > 7) ADCSRB |= (1 << MUX5);
+    else             ADCSRB &= ~(1 << MUX5);
+    _lastChannel = channel;
+}
+
+// ========================
+// Background Scanner
+// ========================
+/**
+ * Starts sweeping the given channel list in the background.
+ * Results are published per sweep through getSnapshot().
+ * The oversampling of channels at 10 bits or less is rounded down to
+ * a power of two so the ISR can shift instead of divide.
+ */
+void AVR_ADC::startScan(const uint8_t* channels, uint8_t count, uint8_t oversample) {
+    if (_mode != ADC_MODE_SCAN || channels == nullptr) return;
+    if (count == 0 || count > ADC_NUM_CHANNELS) return;
+    if (oversample == 0 || oversample > 8) return;
+
+    stopScan();
+
+    // Stable insertion sort by reference: one AREF settle per group and sweep
+    for (uint8_t i = 0; i < count; ++i) {
+        uint8_t ch = channels[i] & 0x0F;
+        uint8_t ref = referenceBitsFor(ch);
+        int8_t j = i - 1;
+        while (j >= 0 && referenceBitsFor(_scanChannels[j]) > ref) {
+            _scanChannels[j + 1] = _scanChannels[j];
+            --j;
+        }
+        _scanChannels[j + 1] = ch;
+    }
+    _scanCount = count;
+
+    _scanOversampleLog2 = 0;
+    while ((2 << _scanOversampleLog2) <= oversample) _scanOversampleLog2++;
+    for (uint8_t ch = 0; ch < ADC_NUM_CHANNELS; ++ch) {
+        planChannel(ch);
+    }
+
+    resumeScan();
+}
+
+/**
+ * Restarts the scanner with the channel list of the last startScan().
+ */
+void AVR_ADC::resumeScan() {
+    if (_mode != ADC_MODE_SCAN || _scanCount == 0 || _scanning) return;
+
+    _scanIndex = 0;
+    _sampleCount = 0;
+    _accum = 0;
+    _discardLeft = routeChannel(_scanChannels[0]);
+    _scanning = true;
+
+    ADCSRA |= (1 << ADIF) | (1 << ADIE);   // Clear stale flag
+    startNext();
+}
+
+/**
+ * Stops the scanner after the conversion in progress.
+ * The last published snapshot stays readable, and blocking reads
+ * (analogRead) work until resumeScan() is called.
+ */
+void AVR_ADC::stopScan() {
+    uint8_t sreg = SREG;
+    cli();
+    _scanning = false;
+    _startPending = false;
+    SREG = sreg;
+
+    while (ADCSRA & (1 << ADSC));          // Let a running conversion finish
+    ADCSRA |= (1 << ADIF);                 // Drop its pending interrupt
+}
+
+bool AVR_ADC::getSnapshot(AdcSnapshot& out) {
+    uint16_t seq;
+    do {
+        seq = scanSequence();
+        if (seq == 0) return false;
+        out = _buffers[_front];
+    } while (scanSequence() != seq);       // Publish happened mid-copy
+
+    return true;
+}
+
+void AVR_ADC::setFilterBank(AdcFilterBank* bank) {
+    _filters = bank;
+}
+
+void AVR_ADC::setWindowComparator(AdcWindowComparator* windows) {
+    _windows = windows;
+}
+
+void AVR_ADC::setStatsBank(AdcStatsBank* stats) {
+    _stats = stats;
+}
+
+uint16_t AVR_ADC::scanSequence() {
+    uint8_t sreg = SREG;
+    cli();
+    uint16_t seq = _seq;
+    SREG = sreg;
+    return seq;
+}
+
+/**
+ * Conversion complete: accumulate, advance the sweep, restart the ADC.
+ * Runs in interrupt context with roughly 100 us until the next call.
+ */
+void AVR_ADC::handleInterrupt() {
+    if (_mode == ADC_MODE_TIMER) {
+        pushStreamSample();
+        return;
+    }
+    if (!_scanning) return;
+
+    if (_discardLeft) {
+        _discardLeft--;                    // Still settling: drop the result
+        startNext();
+        return;
+    }
+
+    uint8_t ch = _scanChannels[_scanIndex];
+    _accum += ADCW;
+    if (++_sampleCount < _chSamples[ch]) {
+        startNext();                       // Same channel, next sample
+        return;
+    }
+
+    uint16_t value = _accum >> _chShift[ch];
+    if (_filters) value = _filters->process(ch, value);
+    if (_windows) _windows->check(ch, value);
+    if (_stats) _stats->add(ch, value);
+    TRACE_ADC_DONE_EVT(ch);
+
+    uint8_t back = _front ^ 1;
+    _buffers[back].value[ch] = value;
+    _accum = 0;
+    _sampleCount = 0;
+
+    if (++_scanIndex >= _scanCount) {
+        // Sweep complete: publish and start filling the other buffer.
+        // seq skips 0 on wrap-around: 0 means "no sweep yet" to getSnapshot()
+        _scanIndex = 0;
+        uint16_t seq = _seq + 1;
+        if (seq == 0) seq = 1;
+        _buffers[back].seq = seq;
+        _front = back;
+        _seq = seq;
+        METRIC_INC(ADC_SCANS);
+    }
+
+    _discardLeft = routeChannel(_scanChannels[_scanIndex]);
+    startNext();
+}
+
+// ========================
+// Timer-Triggered Stream
+// ========================
+/**
+ * Starts Timer1 as the conversion trigger for one channel.
+ * Any samples still in the ring buffer are discarded.
+ */
+void AVR_ADC::startStream(uint8_t channel, uint16_t sampleRateHz) {
+    if (_mode != ADC_MODE_TIMER || channel > 15 || sampleRateHz == 0) return;
+    if (sampleRateHz > ADC_STREAM_MAX_RATE) sampleRateHz = ADC_STREAM_MAX_RATE;
+
+    stopStream();
+    selectChannel(channel);
+    _head = 0;
+    _tail = 0;
+    _overruns = 0;
+
+    // A triggered conversion takes 13.5 ADC clocks: 125 kHz tops out near 9 kSPS
+    uint8_t prescalerBits = (sampleRateHz > 9000) ? 0b110 : 0b111;  // 64 or 128
+    ADCSRA = (ADCSRA & ~((1 << ADPS2) | (1 << ADPS1) | (1 << ADPS0))) | prescalerBits;
+
+    // Timer1 CTC: TOP = OCR1A, compare B at TOP gives one trigger per period
+    uint32_t period = F_CPU / 8 / sampleRateHz;
+    uint8_t clockBits = (1 << CS11);                   // Prescaler 8
+    if (period > 65536UL) {
+        period = F_CPU / 256 / sampleRateHz;
+        clockBits = (1 << CS12);                       // Prescaler 256
+    }
+
+    TCCR1A = 0;
+    TCCR1B = 0;
+    TCNT1 = 0;
+    OCR1A = period - 1;
+    OCR1B = period - 1;
+    TIFR1 = (1 << OCF1B);
+    TCCR1B = (1 << WGM12) | clockBits;
+}
+
+/**
+ * Stops Timer1; the ADC is not triggered again.
+ * Samples already in the ring buffer remain readable.
+ */
+void AVR_ADC::stopStream() {
+    TCCR1B = 0;
+    TIFR1 = (1 << OCF1B);
+}
+
+uint8_t AVR_ADC::readBlock(uint16_t* dst, uint8_t max) {
+    if (dst == nullptr) return 0;
+
+    uint8_t head = _head;                  // Single byte: no tearing
+    uint8_t tail = _tail;
+    uint8_t n = 0;
+
+    while (tail != head && n < max) {
+        dst[n++] = _ring[tail];
+        tail = (tail + 1) & (ADC_STREAM_SIZE - 1);
+    }
+    _tail = tail;
+    return n;
+}
+
+uint8_t AVR_ADC::streamAvailable() {
+    return (_head - _tail) & (ADC_STREAM_SIZE - 1);
+}
+
+uint16_t AVR_ADC::streamOverruns() {
+    uint8_t sreg = SREG;
+    cli();
+    uint16_t overruns = _overruns;
+    SREG = sreg;
+    return overruns;
+}
+
+/**
+ * Stores one triggered conversion. A full ring drops the new sample
+ * so the consumer always sees a gap-free prefix.
+ */
+void AVR_ADC::pushStreamSample() {
+    TIFR1 = (1 << OCF1B);                  // Re-arm: trigger is the flag's rising edge
+
+    uint16_t raw = ADCW;
+    uint8_t next = (_head + 1) & (ADC_STREAM_SIZE - 1);
+    if (next == _tail) {
+        _overruns++;
+        METRIC_INC(ADC_STREAM_DROPS);
+        postmortem.log(PM_OVERFLOW, PM_SRC_ADC_STREAM);
+        return;
+    }
+    _ring[_head] = scaleRaw(raw);
+    _head = next;
+}
+
+ISR(ADC_vect) {
+    TRACE_ISR_ENTER_EVT(TRACE_ISR_ADC);
+    adc.handleInterrupt();
+    TRACE_ISR_EXIT_EVT(TRACE_ISR_ADC);
+}
+
 // ========================
 // Global ADC Object
 // ========================
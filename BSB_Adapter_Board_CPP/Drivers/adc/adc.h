@@ -10,13 +10,21 @@
  * ================================
  * MODE_EXVREF   ? External AREF pin
  * MODE_AVCC     ? AVcc (5V/3.3V) with external capacitor on AREF pin
- * MODE_INT_1V1  ? Internal 1.1V reference
- * MODE_INT_2V56 ? Not supported on ATmega2560 (fallback to AVCC)
+ * MODE_INT_1V1  ? Internal 1.1V reference (REFS1:0 = 10)
+ * MODE_INT_2V56 ? Internal 2.56V reference (REFS1:0 = 11)
+ * ADC_REF_GLOBAL ? Per-channel setting: follow setReference()
  */
 #define MODE_EXVREF    0
 #define MODE_AVCC      1
 #define MODE_INT_1V1   2
 #define MODE_INT_2V56  3
+#define ADC_REF_GLOBAL 0xFF
+
+/*
+ * Time AREF needs after a reference switch (100 nF on AREF against the
+ * ~32 kOhm internal reference). Converted into discarded conversions.
+ */
+#define ADC_REF_SETTLE_US 5000
 
 /*
  * ================================
@@ -24,9 +32,34 @@
  * ================================
  * ADC_MODE_SINGLE ? One conversion per call (analogRead)
  * ADC_MODE_FREE   ? Continuous conversion (readLatest)
+ * ADC_MODE_SCAN   ? Interrupt-driven background scan (getSnapshot)
+ * ADC_MODE_TIMER  ? Timer1-triggered fixed-rate stream (readBlock)
  */
 #define ADC_MODE_SINGLE 0
 #define ADC_MODE_FREE   1
+#define ADC_MODE_SCAN   2
+#define ADC_MODE_TIMER  3
+
+#define ADC_NUM_CHANNELS 16
+
+#define ADC_STREAM_SIZE      128    // Ring buffer entries (power of two, <= 128)
+#define ADC_STREAM_MAX_RATE  15000  // Highest supported sample rate (Hz)
+
+/**
+ * @brief One complete sweep of the background scanner.
+ *
+ * value[] is indexed by channel number and scaled to each channel's
+ * resolution; channels that are not in the scan list stay 0.
+ * seq increments with every published sweep and skips 0 when it wraps.
+ */
+struct AdcSnapshot {
+    uint16_t seq;
+    uint16_t value[ADC_NUM_CHANNELS];
+};
+
+class AdcFilterBank;
+class AdcWindowComparator;
+class AdcStatsBank;
 
 class AVR_ADC {
 public:
@@ -44,9 +77,46 @@ public:
     void init(uint8_t mode, uint32_t adcClockHz = 125000);
 
     void setReference(uint8_t mode);
-    void setResolution(uint8_t bits);    // 8, 9, or 10 bits (scales output)
+    void setResolution(uint8_t bits);    // 8-13 bits (11-13 via oversampling)
     uint8_t getResolution();
 
+    /**
+     * Per-channel resolution for analogRead() and the scanner
+     * @param channel  ADC channel (0-15)
+     * @param bits     8-13, or 0 to follow setResolution()
+     */
+    void setChannelResolution(uint8_t channel, uint8_t bits);
+    uint8_t getChannelResolution(uint8_t channel);
+
+    /**
+     * Conversions thrown away after the mux switches to this channel
+     * @param channel  ADC channel (0-15)
+     * @param count    0-15; 1-2 lets high-impedance dividers (>10 kOhm)
+     *                 recharge the sample-and-hold capacitor
+     */
+    void setChannelDiscard(uint8_t channel, uint8_t count);
+
+    /**
+     * ADC clock for one channel, overriding the one chosen in init()
+     * @param channel     ADC channel (0-15)
+     * @param adcClockHz  Desired clock (closest prescaler at or below),
+     *                    or 0 to follow init(). Above 200 kHz accuracy
+     *                    drops below 10 bits: use it for 8-bit channels.
+     */
+    void setChannelClock(uint8_t channel, uint32_t adcClockHz);
+
+    /**
+     * Reference for one channel
+     * @param channel  ADC channel (0-15)
+     * @param mode     MODE_xx, or ADC_REF_GLOBAL to follow setReference()
+     *
+     * A reference switch costs ADC_REF_SETTLE_US of discarded conversions.
+     * startScan() groups the sweep by reference, so a sweep over n
+     * references switches n times: between the groups and once more at
+     * the wrap back to the first group. With one reference it never does.
+     */
+    void setChannelReference(uint8_t channel, uint8_t mode);
+
     uint16_t analogRead(uint8_t channel);  // Single-shot blocking read
     uint16_t readLatest();                 // Free-running read (non-blocking)
 	
@@ -58,6 +128,46 @@ public:
      */
     uint16_t analogReadOversampled(uint8_t channel, uint8_t oversample);
 
+    /**
+     * Oversample and decimate: 4^n samples, 32-bit sum shifted right by n
+     * @param channel  ADC channel (0-15)
+     * @param bits     Effective resolution 10-13 (n = bits - 10)
+     * @return Result in 0 .. 2^bits - 1
+     */
+    uint16_t analogReadDecimated(uint8_t channel, uint8_t bits, bool noiseReduced = false);
+
+    /**
+     * analogRead() with the core asleep during each conversion
+     * @param channel  ADC channel (0-15)
+     *
+     * Enters SLEEP_MODE_ADC (ADC Noise Reduction) so the conversion starts
+     * with the CPU and clkIO halted, and ADC_vect wakes the core. While
+     * asleep Timer0 and the USARTs stop as well, so each conversion:
+     *   - waits until Timer0 has room for it before the next 1 ms tick and
+     *     adds the halted time back to TCNT0, keeping the tick exact
+     *   - falls back to a normal conversion while a UART is still shifting
+     *     out a byte (see sleepFallbacks())
+     * A byte *received* during the ~110 us sleep is lost; only use this
+     * when no UART expects unsolicited traffic.
+     */
+    uint16_t analogReadNoiseReduced(uint8_t channel);
+
+    /**
+     * Let the background scanner start conversions from sleep
+     * @param enable  true: conversions start in idle(), false: from ADC_vect
+     *
+     * With noise reduction the next conversion is only started when the
+     * scheduler has nothing to do, so sweeps slow down under load.
+     */
+    void setNoiseReduction(bool enable);
+
+    /**
+     * Idle hook: starts a pending scan conversion in ADC Noise Reduction
+     * sleep. Call from the scheduler when no task is ready.
+     */
+    void idle();
+    uint16_t sleepFallbacks();             // Conversions that could not sleep
+
     /**
      * Read all 16 channels with oversampling
      * @param oversample  Number of samples to average (18)
@@ -65,9 +175,137 @@ public:
      */
     void analogReadAllOversampled(uint8_t oversample, uint16_t* buffer);
 
+    /**
+     * Start the background scanner (requires ADC_MODE_SCAN)
+     * @param channels    List of channels (0-15) to sweep, in order
+     * @param count       Number of entries in channels (1-16)
+     * @param oversample  Samples averaged per channel (1-8, rounded down
+     *                    to a power of two); channels above 10 bits use
+     *                    4^n samples instead
+     *
+     * Each conversion completes in ADC_vect, which accumulates the samples,
+     * selects the next channel (including MUX5 for 8-15) and restarts the
+     * ADC. The CPU only pays the ISR overhead.
+     *
+     * The sweep order is the given list stably grouped by reference;
+     * snapshots are indexed by channel, so readers are not affected.
+     */
+    void startScan(const uint8_t* channels, uint8_t count, uint8_t oversample);
+    void stopScan();
+    void resumeScan();
+
+    /**
+     * Copy the most recent complete sweep
+     * @param out  Receives a consistent set of channel values
+     * @return false until the first sweep has completed
+     *
+     * Lock-free: the ISR never waits for readers. A copy that overlaps a
+     * publish is detected through the sequence number and retried.
+     */
+    bool getSnapshot(AdcSnapshot& out);
+    uint16_t scanSequence();               // Completed sweeps (wraps, skipping 0)
+
+    /**
+     * Run every scanned result through a filter bank before publishing
+     * @param bank  Filter chains per channel, or nullptr for raw results
+     */
+    void setFilterBank(AdcFilterBank* bank);
+
+    /**
+     * Check every scanned result against per-channel limits
+     * @param windows  Comparator fed after the filter bank, or nullptr
+     */
+    void setWindowComparator(AdcWindowComparator* windows);
+
+    /**
+     * Feed every scanned result into running statistics
+     * @param stats  Statistics fed after the filter bank, or nullptr
+     */
+    void setStatsBank(AdcStatsBank* stats);
+
+    /**
+     * Start fixed-rate sampling of one channel (requires ADC_MODE_TIMER)
+     * @param channel       ADC channel (0-15)
+     * @param sampleRateHz  1 Hz to ADC_STREAM_MAX_RATE
+     *
+     * Timer1 runs in CTC mode and its compare match B auto-triggers each
+     * conversion (ADTS = 101), so samples are evenly spaced regardless of
+     * CPU load. The rate is exact when 2 MHz (or 62.5 kHz below 31 Hz) is a
+     * multiple of it. Above 9 kSPS the ADC clock is raised to 250 kHz.
+     */
+    void startStream(uint8_t channel, uint16_t sampleRateHz);
+    void stopStream();
+
+    /**
+     * Drain up to max samples from the stream ring buffer
+     * @return Number of samples copied to dst
+     */
+    uint8_t readBlock(uint16_t* dst, uint8_t max);
+    uint8_t streamAvailable();             // Samples waiting in the ring
+    uint16_t streamOverruns();             // Samples dropped on a full ring
+
+    void handleInterrupt();                // Called from ADC_vect only
+
 private:
+    void selectChannel(uint8_t channel);
+    uint16_t routeChannel(uint8_t channel);
+    uint8_t referenceBitsFor(uint8_t channel);
+    void pushStreamSample();
+    void planChannel(uint8_t channel);
+    bool canReadBlocking();
+    uint16_t readRaw(uint8_t channel, bool noiseReduced = false);
+    bool sleepConvert();
+    void startNext();
+    uint16_t scaleRaw(uint16_t raw);
+
     uint8_t _resolution = 10;
     uint8_t _mode = ADC_MODE_SINGLE;
+    uint8_t _prescalerBits = 0b111;        // ADPS2:0 chosen in init()
+    uint8_t _refBits = (1 << REFS0);       // REFS1:0 from setReference()
+    uint8_t _lastChannel = 0xFF;           // Channel the mux points at
+
+    // Per-channel resolution and the scan plan derived from it
+    uint8_t _chResolution[ADC_NUM_CHANNELS] = {};  // 0 = follow _resolution
+    uint8_t _chSamples[ADC_NUM_CHANNELS] = {};     // Conversions per result
+    uint8_t _chShift[ADC_NUM_CHANNELS] = {};       // Right shift of the sum
+
+    // Per-channel conversion settings (0 / ADC_REF_GLOBAL = follow global)
+    uint8_t _chDiscard[ADC_NUM_CHANNELS] = {};
+    uint8_t _chPrescaler[ADC_NUM_CHANNELS] = {};   // ADPS2:0
+    uint8_t _chReference[ADC_NUM_CHANNELS] = {
+        ADC_REF_GLOBAL, ADC_REF_GLOBAL, ADC_REF_GLOBAL, ADC_REF_GLOBAL,
+        ADC_REF_GLOBAL, ADC_REF_GLOBAL, ADC_REF_GLOBAL, ADC_REF_GLOBAL,
+        ADC_REF_GLOBAL, ADC_REF_GLOBAL, ADC_REF_GLOBAL, ADC_REF_GLOBAL,
+        ADC_REF_GLOBAL, ADC_REF_GLOBAL, ADC_REF_GLOBAL, ADC_REF_GLOBAL
+    };
+    uint16_t _chRefSettle[ADC_NUM_CHANNELS] = {};  // Discards after a reference switch
+
+    // Background scanner state (owned by ADC_vect while scanning)
+    uint8_t _scanChannels[ADC_NUM_CHANNELS];
+    uint8_t _scanCount = 0;
+    uint8_t _scanIndex = 0;
+    uint8_t _scanOversampleLog2 = 0;
+    uint8_t _sampleCount = 0;
+    uint16_t _discardLeft = 0;             // Settling conversions still to skip
+    uint32_t _accum = 0;
+    volatile bool _scanning = false;
+    bool _noiseReduction = false;
+    volatile bool _startPending = false;   // Scanner waits for idle()
+    uint16_t _sleepFallbacks = 0;
+    AdcFilterBank* volatile _filters = nullptr;
+    AdcWindowComparator* volatile _windows = nullptr;
+    AdcStatsBank* volatile _stats = nullptr;
+
+    // Double buffer: ISR fills _buffers[_front ^ 1], then flips _front
+    AdcSnapshot _buffers[2];
+    volatile uint8_t _front = 0;
+    volatile uint16_t _seq = 0;
+
+    // Stream ring buffer: ISR advances _head, readBlock() advances _tail
+    uint16_t _ring[ADC_STREAM_SIZE];
+    volatile uint8_t _head = 0;
+    volatile uint8_t _tail = 0;
+    volatile uint16_t _overruns = 0;
 };
 
 
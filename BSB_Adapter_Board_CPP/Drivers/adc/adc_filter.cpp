@@ -0,0 +1,124 @@
+#include "adc_filter.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+// ========================
+// Configuration
+// ========================
+/**
+ * Installs a new chain and lets it prime again from the next sample, so
+ * the median window and EMA state never mix the old and new settings.
+ * ADC_vect runs process() on the config, hence the copy under cli().
+ */
+void AdcFilterBank::configure(uint8_t channel, const AdcFilterConfig& config) {
+    if (channel >= ADC_NUM_CHANNELS) return;
+
+    AdcFilterConfig c = config;
+    if (c.median != 3 && c.median != 5) c.median = 0;
+    if (c.emaShift > 8) c.emaShift = 8;
+
+    uint8_t sreg = SREG;
+    cli();
+    _channels[channel].config = c;
+    _channels[channel].primed = false;
+    SREG = sreg;
+}
+
+void AdcFilterBank::reset(uint8_t channel) {
+    if (channel >= ADC_NUM_CHANNELS) return;
+
+    uint8_t sreg = SREG;
+    cli();
+    _channels[channel].primed = false;
+    SREG = sreg;
+}
+
+uint8_t AdcFilterBank::lowPassAlpha(uint32_t cutoffMilliHz, uint32_t rateMilliHz) {
+    // alpha only depends on the ratio: halve both until cutoff * 1608 and
+    // wc << 8 fit into 32 bits (cutoffs above ~2 kHz)
+    while (cutoffMilliHz >= (1UL << 21) || rateMilliHz >= (1UL << 31)) {
+        cutoffMilliHz >>= 1;
+        rateMilliHz >>= 1;
+    }
+
+    uint32_t wc = (cutoffMilliHz * 1608UL) >> 8;   // 2*pi ~ 1608/256
+    if (rateMilliHz + wc == 0) return 255;
+
+    uint32_t alpha = (wc << 8) / (rateMilliHz + wc);
+    if (alpha < 1)   alpha = 1;
+    if (alpha > 255) alpha = 255;
+    return (uint8_t)alpha;
+}
+
+// ========================
+// Sample Processing
+// ========================
+/**
+ * Median of the last 3 or 5 samples: a single spike never passes.
+ */
+uint16_t AdcFilterBank::median(Channel& c, uint16_t sample) {
+    uint8_t n = c.config.median;
+
+    c.history[c.historyIndex] = sample;
+    if (++c.historyIndex >= n) c.historyIndex = 0;
+
+    if (n == 3) {
+        uint16_t a = c.history[0], b = c.history[1], d = c.history[2];
+        if (a > b) { uint16_t t = a; a = b; b = t; }
+        if (b > d) b = d;
+        return (a > b) ? a : b;
+    }
+
+    // n == 5: insertion sort of a copy, take the middle entry
+    uint16_t s[5];
+    for (uint8_t i = 0; i < 5; ++i) {
+        uint16_t v = c.history[i];
+        int8_t j = i - 1;
+        while (j >= 0 && s[j] > v) {
+            s[j + 1] = s[j];
+            --j;
+        }
+        s[j + 1] = v;
+    }
+    return s[2];
+}
+
+uint16_t AdcFilterBank::process(uint8_t channel, uint16_t sample) {
+    if (channel >= ADC_NUM_CHANNELS) return sample;
+    Channel& c = _channels[channel];
+
+    if (!c.primed) {
+        // Start every stage at the first sample instead of 0
+        for (uint8_t i = 0; i < 5; ++i) c.history[i] = sample;
+        c.historyIndex = 0;
+        c.ema = (int32_t)sample << ADC_FILTER_EMA_FRAC;
+        c.iir = (int32_t)sample << ADC_FILTER_IIR_FRAC;
+        c.primed = true;
+        return sample;
+    }
+
+    uint16_t y = sample;
+
+    if (c.config.median) {
+        y = median(c, y);
+    }
+
+    if (c.config.emaShift) {
+        // y += (x - y) / 2^k, with ADC_FILTER_EMA_FRAC bits kept below the LSB
+        c.ema += (((int32_t)y << ADC_FILTER_EMA_FRAC) - c.ema) >> c.config.emaShift;
+        y = (uint16_t)((c.ema + (1 << (ADC_FILTER_EMA_FRAC - 1))) >> ADC_FILTER_EMA_FRAC);
+    }
+
+    if (c.config.iirAlpha) {
+        // y += alpha * (x - y), alpha = iirAlpha / 256
+        c.iir += ((((int32_t)y << ADC_FILTER_IIR_FRAC) - c.iir) * c.config.iirAlpha) >> 8;
+        y = (uint16_t)((c.iir + (1 << (ADC_FILTER_IIR_FRAC - 1))) >> ADC_FILTER_IIR_FRAC);
+    }
+
+    return y;
+}
+
+// ========================
+// Global Filter Bank
+// ========================
+AdcFilterBank adcFilters;
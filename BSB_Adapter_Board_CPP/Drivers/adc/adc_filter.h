@@ -0,0 +1,83 @@
+#ifndef ADC_FILTER_H
+#define ADC_FILTER_H
+
+#include <stdint.h>
+#include "adc.h"
+
+/*
+ * ================================
+ * Per-Channel ADC Filter Chain
+ * ================================
+ * Each channel runs, in this order:
+ *
+ *   raw -> median-of-3/5 -> EMA (alpha = 2^-k) -> first-order IIR -> out
+ *
+ * Every stage is optional and integer-only (no soft-float), and process()
+ * handles one sample at a time so it can run from ADC_vect.
+ *
+ * Estimated cost per sample (avr-gcc -Os, ATmega2560, 16 MHz); measure the
+ * actual figures on the target with adcFilterBenchmark():
+ *
+ * | Stage            | Cycles | Notes                              |
+ * |------------------|--------|------------------------------------|
+ * | call + bypass    |  ~40   | All stages off                     |
+ * | median of 3      |  ~60   | 3 compares on a 3-entry history    |
+ * | median of 5      | ~150   | Insertion sort of a 5-entry copy   |
+ * | EMA (shift k)    |  ~45   | Q4 state, 32-bit add/shift         |
+ * | IIR (alpha/256)  |  ~90   | Q8 state, 32x8 multiply            |
+ */
+
+#define ADC_FILTER_EMA_FRAC  4   // Fraction bits of the EMA state
+#define ADC_FILTER_IIR_FRAC  8   // Fraction bits of the IIR state
+
+struct AdcFilterConfig {
+    uint8_t median;     // 0 = off, 3 or 5 samples
+    uint8_t emaShift;   // 0 = off, alpha = 1 / 2^emaShift (1-8)
+    uint8_t iirAlpha;   // 0 = off, alpha = iirAlpha / 256
+};
+
+class AdcFilterBank {
+public:
+    /**
+     * Set the filter chain of one channel and reset its state
+     * @param channel  ADC channel (0-15)
+     */
+    void configure(uint8_t channel, const AdcFilterConfig& config);
+
+    /**
+     * Run one sample through the channel's chain
+     * @return Filtered value in the same scale as the input
+     *
+     * The first sample after configure()/reset() primes all stages,
+     * so the output never ramps up from 0.
+     */
+    uint16_t process(uint8_t channel, uint16_t sample);
+
+    void reset(uint8_t channel);
+
+    /**
+     * IIR coefficient for a cutoff frequency (alpha = wc / (fs + wc))
+     * @param cutoffMilliHz  -3 dB frequency in mHz
+     * @param rateMilliHz    Sample rate of the channel in mHz
+     * @return alpha in 1/256 steps (1-255)
+     */
+    static uint8_t lowPassAlpha(uint32_t cutoffMilliHz, uint32_t rateMilliHz);
+
+private:
+    struct Channel {
+        AdcFilterConfig config;
+        uint16_t history[5];    // Median window (ring)
+        uint8_t  historyIndex;
+        bool     primed;
+        int32_t  ema;           // Q4
+        int32_t  iir;           // Q8
+    };
+
+    uint16_t median(Channel& c, uint16_t sample);
+
+    Channel _channels[ADC_NUM_CHANNELS] = {};
+};
+
+extern AdcFilterBank adcFilters;
+
+#endif // ADC_FILTER_H
@@ -0,0 +1,192 @@
+#include "adc_stats.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+// ========================
+// Configuration
+// ========================
+/**
+ * Installs a new bucket layout and drops all collected data, which was
+ * bucketed for the old one. add() in the ADC interrupt reads size and
+ * count together when it closes a bucket, so both change under cli().
+ * A channel seen for the first time takes the first free slot.
+ */
+bool AdcStatsBank::configure(uint8_t channel, uint16_t bucketSamples, uint8_t buckets) {
+    if (channel >= ADC_NUM_CHANNELS) return false;
+    if (buckets < 1) buckets = 1;
+    if (buckets > ADC_STATS_BUCKETS) buckets = ADC_STATS_BUCKETS;
+
+    uint8_t slot = _slotOf[channel];
+    if (bucketSamples == 0) {
+        if (slot) {
+            uint8_t sreg = SREG;
+            cli();
+            _slotOf[channel] = 0;
+            _slots[slot - 1].bucketSamples = 0;
+            SREG = sreg;
+        }
+        return true;
+    }
+
+    for (uint8_t i = 0; !slot && i < ADC_STATS_SLOTS; ++i) {
+        if (_slots[i].bucketSamples == 0) slot = i + 1;
+    }
+    if (!slot) return false;
+
+    uint8_t sreg = SREG;
+    cli();
+    _slots[slot - 1].bucketSamples = bucketSamples;
+    _slots[slot - 1].buckets = buckets;
+    _slotOf[channel] = slot;
+    SREG = sreg;
+
+    reset(channel);
+    return true;
+}
+
+AdcStatsBank::Channel* AdcStatsBank::find(uint8_t channel) {
+    if (channel >= ADC_NUM_CHANNELS || _slotOf[channel] == 0) return nullptr;
+    return &_slots[_slotOf[channel] - 1];
+}
+
+void AdcStatsBank::reset(uint8_t channel) {
+    Channel* c = find(channel);
+    if (!c) return;
+
+    uint8_t sreg = SREG;
+    cli();
+    c->ringIndex = 0;
+    c->filled = 0;
+    c->windows = 0;
+    clear(c->bucket);
+    SREG = sreg;
+}
+
+// ========================
+// Sample Path (ADC_vect)
+// ========================
+void AdcStatsBank::clear(Sums& s) {
+    s.n = 0;
+    s.sum = 0;
+    s.sumSq = 0;
+    s.min = 0xFFFF;
+    s.max = 0;
+}
+
+void AdcStatsBank::merge(Sums& into, const Sums& from) {
+    into.n += from.n;
+    into.sum += from.sum;
+    into.sumSq += from.sumSq;
+    if (from.min < into.min) into.min = from.min;
+    if (from.max > into.max) into.max = from.max;
+}
+
+/**
+ * O(1): one 16x16 multiply and a few adds per sample. Closing a bucket
+ * copies it into the ring; closing the last bucket of a window also sums
+ * the ring into the tumbling result (at most ADC_STATS_BUCKETS merges).
+ */
+void AdcStatsBank::add(uint8_t channel, uint16_t value) {
+    Channel* slot = find(channel);
+    if (!slot) return;
+    Channel& c = *slot;
+
+    Sums& b = c.bucket;
+    b.n++;
+    b.sum += value;
+    b.sumSq += (uint32_t)value * value;
+    if (value < b.min) b.min = value;
+    if (value > b.max) b.max = value;
+
+    if (b.n < c.bucketSamples) return;
+
+    // Bucket complete
+    c.ring[c.ringIndex] = b;
+    clear(b);
+    if (c.filled < c.buckets) c.filled++;
+
+    if (++c.ringIndex >= c.buckets) {
+        c.ringIndex = 0;
+        clear(c.tumbling);
+        for (uint8_t i = 0; i < c.buckets; ++i) {
+            merge(c.tumbling, c.ring[i]);
+        }
+        c.windows++;
+    }
+}
+
+// ========================
+// Readout (task context)
+// ========================
+/**
+ * Mean and population variance from the power sums:
+ *   mean = sum / n,  variance = (n * sumSq - sum^2) / n^2
+ * n * sumSq - sum^2 = n * M2 is computed exactly, so there is no
+ * cancellation no matter how large the mean is against the spread.
+ */
+void AdcStatsBank::finish(const Sums& s, uint16_t window, AdcStats& out) {
+    out.count = s.n;
+    out.min = s.min;
+    out.max = s.max;
+    out.window = window;
+
+    if (s.n == 0) {
+        out.meanQ4 = 0;
+        out.varianceQ4 = 0;
+        return;
+    }
+
+    out.meanQ4 = (uint32_t)((((uint64_t)s.sum << 4) + s.n / 2) / s.n);
+
+    uint64_t nM2 = (uint64_t)s.n * s.sumSq - (uint64_t)s.sum * s.sum;
+    uint64_t m2Q4 = ((nM2 / s.n) << 4) + ((nM2 % s.n) << 4) / s.n;  // Keeps the fraction
+    out.varianceQ4 = (uint32_t)(m2Q4 / s.n);
+}
+
+bool AdcStatsBank::getTumbling(uint8_t channel, AdcStats& out) {
+    const Channel* slot = find(channel);
+    if (!slot) return false;
+    const Channel& c = *slot;
+
+    uint8_t sreg = SREG;
+    cli();
+    Sums s = c.tumbling;
+    uint16_t windows = c.windows;
+    SREG = sreg;
+
+    if (windows == 0) return false;
+    finish(s, windows, out);
+    return true;
+}
+
+bool AdcStatsBank::getSliding(uint8_t channel, AdcStats& out) {
+    const Channel* slot = find(channel);
+    if (!slot) return false;
+    const Channel& c = *slot;
+
+    // Copy the ring under cli; merging happens with interrupts enabled
+    Sums ring[ADC_STATS_BUCKETS];
+    uint8_t sreg = SREG;
+    cli();
+    uint8_t filled = c.filled;
+    uint16_t windows = c.windows;
+    for (uint8_t i = 0; i < filled; ++i) {
+        ring[i] = c.ring[i];
+    }
+    SREG = sreg;
+
+    if (filled == 0) return false;
+
+    Sums s;
+    clear(s);
+    for (uint8_t i = 0; i < filled; ++i) {
+        merge(s, ring[i]);
+    }
+    finish(s, windows, out);
+    return true;
+}
+
+// ========================
+// Global Statistics Bank
+// ========================
+AdcStatsBank adcStats;
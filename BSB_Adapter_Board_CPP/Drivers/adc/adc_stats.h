@@ -0,0 +1,106 @@
+#ifndef ADC_STATS_H
+#define ADC_STATS_H
+
+#include <stdint.h>
+#include "adc.h"
+
+/*
+ * ================================
+ * Per-Channel Running Statistics
+ * ================================
+ * Every final scan result of a configured channel is added to a bucket
+ * of bucketSamples samples. Completed buckets go into a ring of up to
+ * ADC_STATS_BUCKETS entries:
+ *
+ *   tumbling window  buckets x bucketSamples, published each time the
+ *                    ring fills up (non-overlapping)
+ *   sliding window   the most recent completed buckets, advancing by
+ *                    one bucket
+ *
+ * A bucket holds exact integer power sums (n, sum x, sum x^2, min, max):
+ * an estimated ~60 cycles per sample in ADC_vect and no division. Mean
+ * and variance are derived when a task reads them.
+ *
+ * RAM: ~130 bytes per slot. Channels share a pool of ADC_STATS_SLOTS
+ * slots; a channel takes one in configure() and frees it with
+ * bucketSamples 0, so RAM follows the channels that need statistics.
+ */
+#define ADC_STATS_BUCKETS 4
+
+#ifndef ADC_STATS_SLOTS
+#define ADC_STATS_SLOTS 4         // Channels with statistics at a time
+#endif
+
+/**
+ * @brief Statistics over one window, in the channel's resolution.
+ */
+struct AdcStats {
+    uint32_t count;        // Samples in the window
+    uint16_t min;
+    uint16_t max;
+    uint32_t meanQ4;       // Mean x 16
+    uint32_t varianceQ4;   // Population variance x 16 (counts^2)
+    uint16_t window;       // Tumbling windows completed so far
+};
+
+class AdcStatsBank {
+public:
+    /**
+     * Start collecting statistics for one channel
+     * @param channel        ADC channel (0-15)
+     * @param bucketSamples  Samples per bucket (1-65535), 0 = off (frees the slot)
+     * @param buckets        Buckets per window (1-ADC_STATS_BUCKETS)
+     * @return false when all ADC_STATS_SLOTS are taken by other channels
+     *
+     * With the board's ~15 ms sweep, 1000 samples x 4 buckets gives a
+     * one-minute tumbling window and a sliding minute every 15 s.
+     */
+    bool configure(uint8_t channel, uint16_t bucketSamples, uint8_t buckets);
+    void reset(uint8_t channel);
+
+    /**
+     * Last complete tumbling window
+     * @return false until the first window has completed
+     */
+    bool getTumbling(uint8_t channel, AdcStats& out);
+
+    /**
+     * The most recent completed buckets (fewer right after start)
+     * @return false until the first bucket has completed
+     */
+    bool getSliding(uint8_t channel, AdcStats& out);
+
+    void add(uint8_t channel, uint16_t value);  // Called from ADC_vect only
+
+private:
+    struct Sums {
+        uint32_t n;
+        uint32_t sum;
+        uint64_t sumSq;
+        uint16_t min;
+        uint16_t max;
+    };
+
+    struct Channel {
+        uint16_t bucketSamples;    // 0 = slot free
+        uint8_t  buckets;
+        uint8_t  ringIndex;        // Next ring slot to fill
+        uint8_t  filled;           // Valid ring slots
+        uint16_t windows;          // Tumbling windows published
+        Sums     bucket;           // Bucket being filled
+        Sums     ring[ADC_STATS_BUCKETS];
+        Sums     tumbling;         // Last complete tumbling window
+    };
+
+    Channel* find(uint8_t channel);
+    static void clear(Sums& s);
+    static void merge(Sums& into, const Sums& from);
+    static void finish(const Sums& s, uint16_t window, AdcStats& out);
+
+    uint8_t _slotOf[ADC_NUM_CHANNELS] = {};  // Slot index + 1, 0 = no statistics
+    Channel _slots[ADC_STATS_SLOTS] = {};
+};
+
+extern AdcStatsBank adcStats;
+
+#endif // ADC_STATS_H
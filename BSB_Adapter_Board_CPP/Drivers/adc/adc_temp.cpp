@@ -0,0 +1,152 @@
+#include "adc_temp.h"
+#include <avr/pgmspace.h>
+
+// ========================
+// Lookup Tables (flash)
+// ========================
+// Generated by Tools/gen_temp_lut.py -- regenerate instead of editing.
+// Entries are centi-degrees at 10-bit raw counts; segment i covers
+// raw = rawStart + (k << shift) with table index first + k.
+
+/**
+ * One run of evenly spaced table points.
+ */
+struct TempLutSegment {
+    uint16_t rawStart;      // 10-bit count of the segment's first entry
+    uint8_t  shift;         // Entry spacing = 2^shift counts
+    uint8_t  first;         // Table index of that entry
+};
+
+// Series 10000 ohm, valid raw 21..999, 64 points, max error 0.09 degC
+static const int16_t lutNtc10k[64] PROGMEM = {
+     15011,  14574,  14182,  13828,  13504,  13207,  12932,  12439,
+     12006,  11620,  11274,  10959,  10671,  10406,  10160,   9717,
+      9326,   8977,   8661,   8372,   8107,   7862,   7633,   7218,
+      6849,   6515,   6211,   5930,   5669,   5196,   4772,   4387,
+      4030,   3696,   3379,   3077,   2784,   2500,   2221,   1945,
+      1670,   1393,   1113,    825,    528,    217,   -114,   -471,
+      -867,  -1318,  -1575,  -1859,  -2182,  -2560,  -2666,  -2778,
+     -2897,  -3023,  -3159,  -3304,  -3463,  -3637,  -3831,  -4050
+};
+
+static const TempLutSegment segNtc10k[7] PROGMEM = {
+    {   20, 1,  0 },
+    {   32, 2,  6 },
+    {   64, 3, 14 },
+    {  128, 4, 22 },
+    {  224, 5, 28 },
+    {  896, 4, 49 },
+    {  960, 2, 53 },
+};
+
+// Series 1000 ohm, valid raw 457..675, 29 points, max error 0.11 degC
+static const int16_t lutPt1000[29] PROGMEM = {
+     -5008,  -4358,  -3688,  -2997,  -2284,  -1547,   -786,      0,
+       813,   1655,   2526,   3429,   4365,   5336,   6344,   7391,
+      8480,   9613,  10793,  12023,  13306,  14645,  16046,  17511,
+     19045,  20655,  22344,  24120,  25990
+};
+
+static const TempLutSegment segPt1000[1] PROGMEM = {
+    {  456, 3,  0 },
+};
+
+/**
+ * Table layout per sensor type. Readings outside rawMin..rawMax mean an
+ * open or shorted sensor and convert to TEMP_INVALID; the table reaches
+ * one point past both limits.
+ */
+struct TempSensorLut {
+    const int16_t* table;             // PROGMEM
+    const TempLutSegment* segments;   // PROGMEM, ascending rawStart
+    uint8_t  segmentCount;
+    uint16_t rawMin;
+    uint16_t rawMax;
+};
+
+static const TempSensorLut sensorLuts[TEMP_SENSOR_COUNT] = {
+    { nullptr,   nullptr,   0, 0,   0   },  // TEMP_SENSOR_NONE
+    { lutNtc10k, segNtc10k, 7, 21,  999 },  // TEMP_SENSOR_NTC10K
+    { lutPt1000, segPt1000, 1, 457, 675 },  // TEMP_SENSOR_PT1000
+};
+
+// ========================
+// Calibration
+// ========================
+TempConverter::TempConverter() {
+    for (uint8_t ch = 0; ch < ADC_NUM_CHANNELS; ++ch) {
+        _cal[ch].sensor = TEMP_SENSOR_NONE;
+        _cal[ch].offset = 0;
+        _cal[ch].gain = TEMP_GAIN_UNITY;
+    }
+}
+
+void TempConverter::setSensor(uint8_t channel, uint8_t sensor) {
+    if (channel >= ADC_NUM_CHANNELS || sensor >= TEMP_SENSOR_COUNT) return;
+    _cal[channel].sensor = sensor;
+}
+
+void TempConverter::setCalibration(uint8_t channel, const TempCalibration& cal) {
+    if (channel >= ADC_NUM_CHANNELS || cal.sensor >= TEMP_SENSOR_COUNT) return;
+    _cal[channel] = cal;
+}
+
+TempCalibration TempConverter::getCalibration(uint8_t channel) {
+    if (channel >= ADC_NUM_CHANNELS) channel = 0;
+    return _cal[channel];
+}
+
+void TempConverter::loadCalibration(const TempCalibration* table, uint8_t count) {
+    if (table == nullptr) return;
+    if (count > ADC_NUM_CHANNELS) count = ADC_NUM_CHANNELS;
+
+    for (uint8_t ch = 0; ch < count; ++ch) {
+        setCalibration(ch, table[ch]);
+    }
+}
+
+// ========================
+// Conversion
+// ========================
+/**
+ * Works on a 10.6 fixed-point position so 8-13-bit inputs share one
+ * table: the top 10 bits pick the entry, the rest interpolate.
+ */
+int16_t TempConverter::toCentiCelsius(uint8_t channel, uint16_t raw, uint8_t bits) {
+    if (channel >= ADC_NUM_CHANNELS || bits < 8 || bits > 13) return TEMP_INVALID;
+
+    const TempCalibration& cal = _cal[channel];
+    if (cal.sensor == TEMP_SENSOR_NONE || cal.sensor >= TEMP_SENSOR_COUNT) return TEMP_INVALID;
+    const TempSensorLut& lut = sensorLuts[cal.sensor];
+
+    uint16_t pos = raw << (16 - bits);                 // 10.6 fixed point
+    uint16_t count = pos >> 6;
+    if (count < lut.rawMin || count > lut.rawMax) return TEMP_INVALID;
+
+    // Last segment starting at or below the reading (at most 7 to pass)
+    const TempLutSegment* seg = lut.segments;
+    for (uint8_t s = 1; s < lut.segmentCount; ++s) {
+        if (count < pgm_read_word(&lut.segments[s].rawStart)) break;
+        seg = &lut.segments[s];
+    }
+
+    uint16_t offset = pos - (pgm_read_word(&seg->rawStart) << 6);
+    uint8_t fracBits = pgm_read_byte(&seg->shift) + 6;
+    uint8_t index = pgm_read_byte(&seg->first) + (offset >> fracBits);
+    uint16_t frac = offset & ((1 << fracBits) - 1);
+
+    int16_t t0 = (int16_t)pgm_read_word(&lut.table[index]);
+    int16_t t1 = (int16_t)pgm_read_word(&lut.table[index + 1]);
+    int32_t t = t0 + (((int32_t)(t1 - t0) * frac) >> fracBits);
+
+    // Trim: gain in Q12, then offset
+    t = ((t * cal.gain) >> 12) + cal.offset;
+    if (t > 32767) t = 32767;
+    if (t <= TEMP_INVALID) t = TEMP_INVALID + 1;
+    return (int16_t)t;
+}
+
+// ========================
+// Global Converter
+// ========================
+TempConverter adcTemp;
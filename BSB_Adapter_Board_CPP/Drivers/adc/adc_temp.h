@@ -0,0 +1,72 @@
+#ifndef ADC_TEMP_H
+#define ADC_TEMP_H
+
+#include <stdint.h>
+#include "adc.h"
+
+/*
+ * ================================
+ * Temperature Sensor Types
+ * ================================
+ * TEMP_SENSOR_NONE    ? Channel is not a temperature input
+ * TEMP_SENSOR_NTC10K  ? 10 kOhm NTC (B3950), 10 kOhm pull-up to AVcc
+ * TEMP_SENSOR_PT1000  ? PT1000 RTD, 1 kOhm pull-up to AVcc
+ *
+ * Conversion uses piecewise-linear lookup tables in flash (generated by
+ * Tools/gen_temp_lut.py) instead of log() and float Steinhart-Hart. Points
+ * are closer together where the curve bends (NTC ends); interpolation
+ * stays within about 0.1 degC of the curve over the whole valid range.
+ */
+#define TEMP_SENSOR_NONE    0
+#define TEMP_SENSOR_NTC10K  1
+#define TEMP_SENSOR_PT1000  2
+#define TEMP_SENSOR_COUNT   3
+
+#define TEMP_GAIN_UNITY     4096     // Q12 gain of 1.0
+#define TEMP_INVALID        (-32767 - 1)  // Open/shorted sensor or no sensor
+
+/**
+ * @brief Per-channel sensor selection and trim.
+ *
+ * result = lut(raw) * gain / 4096 + offset
+ */
+struct TempCalibration {
+    uint8_t sensor;   // TEMP_SENSOR_xx
+    int16_t offset;   // Centi-degrees added after the gain
+    int16_t gain;     // Q12 scale factor (TEMP_GAIN_UNITY = 1.0)
+};
+
+class TempConverter {
+public:
+    TempConverter();
+
+    void setSensor(uint8_t channel, uint8_t sensor);
+    void setCalibration(uint8_t channel, const TempCalibration& cal);
+    TempCalibration getCalibration(uint8_t channel);
+
+    /**
+     * Load calibration constants at runtime (e.g. from EEPROM)
+     * @param table  One entry per channel, starting at channel 0
+     * @param count  Number of entries (at most 16)
+     */
+    void loadCalibration(const TempCalibration* table, uint8_t count);
+
+    /**
+     * Convert ADC counts to centi-degrees Celsius
+     * @param channel  ADC channel (0-15) whose sensor type and trim apply
+     * @param raw      ADC reading
+     * @param bits     Resolution of raw (8-13), e.g. getChannelResolution()
+     * @return Temperature in 0.01 degC, or TEMP_INVALID
+     *
+     * A short segment scan, two table reads, one 16x16 multiply and
+     * shifts; no division.
+     */
+    int16_t toCentiCelsius(uint8_t channel, uint16_t raw, uint8_t bits = 10);
+
+private:
+    TempCalibration _cal[ADC_NUM_CHANNELS];
+};
+
+extern TempConverter adcTemp;
+
+#endif // ADC_TEMP_H
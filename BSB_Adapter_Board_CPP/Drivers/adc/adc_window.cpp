@@ -0,0 +1,122 @@
+#include "adc_window.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "postmortem.h"
+
+// ========================
+// Configuration
+// ========================
+/**
+ * Installs new limits. The state restarts as unknown, so the first result
+ * reports where the input is; the ISR must not compare against a mix of
+ * old and new limits while they are written.
+ */
+void AdcWindowComparator::setWindow(uint8_t channel, uint16_t low, uint16_t high,
+                                    uint16_t hysteresis) {
+    if (channel >= ADC_NUM_CHANNELS || low > high) return;
+
+    uint8_t sreg = SREG;
+    cli();
+    Window& w = _windows[channel];
+    w.low = low;
+    w.high = high;
+    w.hysteresis = hysteresis;
+    w.state = ADC_WINDOW_UNKNOWN;
+    _enabled |= (1U << channel);
+    SREG = sreg;
+}
+
+void AdcWindowComparator::clearWindow(uint8_t channel) {
+    if (channel >= ADC_NUM_CHANNELS) return;
+
+    uint8_t sreg = SREG;
+    cli();
+    _enabled &= ~(1U << channel);
+    _windows[channel].state = ADC_WINDOW_UNKNOWN;
+    SREG = sreg;
+}
+
+void AdcWindowComparator::setHandler(void (*handler)()) {
+    _handler = handler;
+}
+
+// ========================
+// Event Queue
+// ========================
+bool AdcWindowComparator::readEvent(AdcWindowEvent& event) {
+    uint8_t tail = _tail;
+    if (tail == _head) return false;       // Single byte: no tearing
+
+    event = _queue[tail];
+    _tail = (tail + 1) & (ADC_WINDOW_QUEUE - 1);
+    return true;
+}
+
+uint8_t AdcWindowComparator::state(uint8_t channel) {
+    if (channel >= ADC_NUM_CHANNELS) return ADC_WINDOW_UNKNOWN;
+    return _windows[channel].state;
+}
+
+uint8_t AdcWindowComparator::dropped() {
+    return _dropped;
+}
+
+// ========================
+// Comparator (ADC_vect)
+// ========================
+/**
+ * Evaluates one final channel result. Unwatched channels and results
+ * equal to the last one return after a mask test or one compare.
+ * A transition is committed only once its event is queued: on a full
+ * queue state and last stay as they were, so the next result retries.
+ */
+void AdcWindowComparator::check(uint8_t channel, uint16_t value) {
+    if (channel >= ADC_NUM_CHANNELS || !(_enabled & (1U << channel))) return;
+
+    Window& w = _windows[channel];
+    if (w.state != ADC_WINDOW_UNKNOWN && value == w.last) return;
+
+    uint8_t next;
+    if (value > w.high) {
+        next = ADC_WINDOW_ABOVE;
+    } else if (value < w.low) {
+        next = ADC_WINDOW_BELOW;
+    } else if (w.state == ADC_WINDOW_ABOVE &&
+               (uint32_t)value + w.hysteresis > w.high) {
+        next = ADC_WINDOW_ABOVE;           // Not far enough back inside
+    } else if (w.state == ADC_WINDOW_BELOW &&
+               value < (uint32_t)w.low + w.hysteresis) {
+        next = ADC_WINDOW_BELOW;
+    } else {
+        next = ADC_WINDOW_INSIDE;
+    }
+
+    // No transition, or the first result is inside: nothing to report
+    if (next == w.state || (w.state == ADC_WINDOW_UNKNOWN && next == ADC_WINDOW_INSIDE)) {
+        w.state = next;
+        w.last = value;
+        return;
+    }
+
+    uint8_t head = _head;
+    uint8_t nextHead = (head + 1) & (ADC_WINDOW_QUEUE - 1);
+    if (nextHead == _tail) {
+        if (_dropped < 0xFF) _dropped++;
+        postmortem.log(PM_OVERFLOW, PM_SRC_ADC_WINDOW);
+        return;
+    }
+    _queue[head].channel = channel;
+    _queue[head].state = next;
+    _queue[head].value = value;
+    _head = nextHead;
+    w.state = next;
+    w.last = value;
+
+    void (*handler)() = _handler;
+    if (handler) handler();
+}
+
+// ========================
+// Global Comparator
+// ========================
+AdcWindowComparator adcWindows;
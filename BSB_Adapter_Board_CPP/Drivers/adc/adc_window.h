@@ -0,0 +1,92 @@
+#ifndef ADC_WINDOW_H
+#define ADC_WINDOW_H
+
+#include <stdint.h>
+#include "adc.h"
+
+/*
+ * ================================
+ * ADC Window Comparator
+ * ================================
+ * Per-channel low/high limits with hysteresis, checked by the background
+ * scanner in ADC_vect right after a channel's result is final (and
+ * filtered). Only transitions produce events:
+ *
+ *            below low            inside            above high
+ *   BELOW  <------------  INSIDE  ------------>  ABOVE
+ *          ------------>          <------------
+ *          >= low + hyst                <= high - hyst
+ *
+ * Events are queued for a task and a handler runs in interrupt context
+ * (typically scheduler.notify()), so the alarm latency is one sweep.
+ * While the queue is full a transition is held back, not lost: the
+ * channel keeps its old state and the next result reports it.
+ */
+#define ADC_WINDOW_INSIDE   0
+#define ADC_WINDOW_BELOW    1
+#define ADC_WINDOW_ABOVE    2
+#define ADC_WINDOW_UNKNOWN  0xFF   // No result since setWindow()
+
+#define ADC_WINDOW_QUEUE    8      // Event queue entries (power of two)
+
+struct AdcWindowEvent {
+    uint8_t  channel;
+    uint8_t  state;     // ADC_WINDOW_xx entered
+    uint16_t value;     // Result that caused the transition
+};
+
+class AdcWindowComparator {
+public:
+    /**
+     * Watch one channel
+     * @param channel     ADC channel (0-15)
+     * @param low, high   Limits in the channel's resolution; the window
+     *                    is low..high inclusive
+     * @param hysteresis  Counts a value must move back inside before the
+     *                    channel counts as inside again
+     *
+     * The first result after setWindow() only raises an event when it is
+     * outside the window.
+     */
+    void setWindow(uint8_t channel, uint16_t low, uint16_t high, uint16_t hysteresis);
+    void clearWindow(uint8_t channel);
+
+    /**
+     * @param handler  Called from ADC_vect after an event was queued
+     */
+    void setHandler(void (*handler)());
+
+    /**
+     * Take the oldest event
+     * @return false when the queue is empty
+     */
+    bool readEvent(AdcWindowEvent& event);
+
+    uint8_t state(uint8_t channel);      // ADC_WINDOW_xx
+    uint8_t dropped();                   // Results not reported on a full queue (retried)
+
+    void check(uint8_t channel, uint16_t value);  // Called from ADC_vect only
+
+private:
+    struct Window {
+        uint16_t low;
+        uint16_t high;
+        uint16_t hysteresis;
+        uint16_t last;      // Last evaluated value
+        uint8_t  state;
+    };
+
+    Window _windows[ADC_NUM_CHANNELS];
+    uint16_t _enabled = 0;               // Bit per watched channel
+
+    // Event queue: check() advances _head, readEvent() advances _tail
+    AdcWindowEvent _queue[ADC_WINDOW_QUEUE];
+    volatile uint8_t _head = 0;
+    volatile uint8_t _tail = 0;
+    volatile uint8_t _dropped = 0;
+    void (* volatile _handler)() = nullptr;
+};
+
+extern AdcWindowComparator adcWindows;
+
+#endif // ADC_WINDOW_H
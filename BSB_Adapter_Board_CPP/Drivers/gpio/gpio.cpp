@@ -1,86 +1,65 @@
 #include "gpio.h"
+#include "gpio_pin.h"
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
 
 // -----------------------------------------------------------------------------
 // Internal Helpers
 // -----------------------------------------------------------------------------
 
 /**
- * @brief Returns the data direction register (DDRx) pointer for a given pin.
+ * @brief PINx data address per port index (pin >> 4), A to L.
  *
- * @param pin Encoded pin value (e.g., APB3 = 19)
- * @return Pointer to DDRx register or nullptr if unsupported
+ * DDRx and PORTx follow at +1 and +2, so one lookup serves all three
+ * registers. Same values as gpioPortBase() used by Pin<>.
  */
-static volatile uint8_t* get_ddr(uint8_t pin) {
-    if (pin >= 0 && pin <= 7)    return &DDRD;  // APAx ? PORTD for testing (simulated APA0APA7)
-    if (pin >= 8 && pin <= 15)   return &DDRC;  // APCx
-    if (pin >= 16 && pin <= 23)  return &DDRB;  // APBx
-    if (pin >= 32 && pin <= 39)  return &DDRC;
-    if (pin >= 48 && pin <= 55)  return &DDRD;
-    if (pin >= 64 && pin <= 71)  return &DDRE;
-    if (pin >= 80 && pin <= 87)  return &DDRF;
-    if (pin >= 96 && pin <= 101) return &DDRG;
-    if (pin >= 112 && pin <= 119) return &DDRH;
-    if (pin >= 128 && pin <= 135) return &DDRJ;
-    if (pin >= 144 && pin <= 151) return &DDRK;
-    if (pin >= 160 && pin <= 167) return &DDRL;
+static const uint16_t port_base[11] PROGMEM = {
+    gpioPortBase(0), gpioPortBase(1), gpioPortBase(2), gpioPortBase(3),   // A-D
+    gpioPortBase(4), gpioPortBase(5), gpioPortBase(6), gpioPortBase(7),   // E-H
+    gpioPortBase(8), gpioPortBase(9), gpioPortBase(10)                    // J-L
+};
 
-    return 0;  // Invalid or unsupported
-}
+static const uint8_t bit_mask[8] PROGMEM = {
+    0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80
+};
 
 /**
- * @brief Returns the PORTx register pointer for a given pin.
+ * @brief Returns the PINx register pointer for a given pin.
+ *
+ * One bounds check and one flash read, whatever the pin.
  *
- * @param pin Encoded pin value
- * @return Pointer to PORTx register or nullptr
+ * @param pin Encoded pin value (e.g., APB3 = 19)
+ * @return Pointer to PINx (DDRx = +1, PORTx = +2) or nullptr if unsupported
  */
-static volatile uint8_t* get_port(uint8_t pin) {
-    if (pin >= 0 && pin <= 7)    return &PORTD;
-    if (pin >= 8 && pin <= 15)   return &PORTC;
-    if (pin >= 16 && pin <= 23)  return &PORTB;
-    if (pin >= 32 && pin <= 39)  return &PORTC;
-    if (pin >= 48 && pin <= 55)  return &PORTD;
-    if (pin >= 64 && pin <= 71)  return &PORTE;
-    if (pin >= 80 && pin <= 87)  return &PORTF;
-    if (pin >= 96 && pin <= 101) return &PORTG;
-    if (pin >= 112 && pin <= 119) return &PORTH;
-    if (pin >= 128 && pin <= 135) return &PORTJ;
-    if (pin >= 144 && pin <= 151) return &PORTK;
-    if (pin >= 160 && pin <= 167) return &PORTL;
-
-    return 0;
+static volatile uint8_t* get_base(uint8_t pin) {
+    if (!gpioValidPin(pin)) return 0;  // Invalid or unsupported
+    return &_SFR_MEM8(pgm_read_word(&port_base[pin >> 4]));
 }
 
 /**
- * @brief Returns the PINx input register pointer for a given pin.
+ * @brief Returns the bit mask within the port for a given pin.
  *
- * @param pin Encoded pin value
- * @return Pointer to PINx register or nullptr
+ * @param pin Encoded pin number
+ * @return Mask with bit 07 set
  */
-static volatile uint8_t* get_pin_reg(uint8_t pin) {
-    if (pin >= 0 && pin <= 7)    return &PIND;
-    if (pin >= 8 && pin <= 15)   return &PINC;
-    if (pin >= 16 && pin <= 23)  return &PINB;
-    if (pin >= 32 && pin <= 39)  return &PINC;
-    if (pin >= 48 && pin <= 55)  return &PIND;
-    if (pin >= 64 && pin <= 71)  return &PINE;
-    if (pin >= 80 && pin <= 87)  return &PINF;
-    if (pin >= 96 && pin <= 101) return &PING;
-    if (pin >= 112 && pin <= 119) return &PINH;
-    if (pin >= 128 && pin <= 135) return &PINJ;
-    if (pin >= 144 && pin <= 151) return &PINK;
-    if (pin >= 160 && pin <= 167) return &PINL;
-
-    return 0;
+static uint8_t get_mask(uint8_t pin) {
+    return pgm_read_byte(&bit_mask[pin & 0x07]);
 }
 
 /**
- * @brief Extracts the bit index within the port for a given pin.
+ * @brief Sets or clears bits of a port register as one atomic step.
  *
- * @param pin Encoded pin number
- * @return Bit index 07
+ * Runtime pointers compile to ld/st, never sbi/cbi, so an ISR writing the
+ * same port between the load and the store would otherwise be undone.
  */
-static uint8_t get_bit(uint8_t pin) {
-    return pin % 8;
+static void update_bits(volatile uint8_t* reg, uint8_t mask, bool set) {
+    uint8_t sreg = SREG;
+    cli();
+    if (set)
+        *reg |= mask;
+    else
+        *reg &= ~mask;
+    SREG = sreg;
 }
 
 // -----------------------------------------------------------------------------
@@ -94,14 +73,10 @@ static uint8_t get_bit(uint8_t pin) {
  * @param mode INPUT or OUTPUT
  */
 void pinMode(uint8_t pin, uint8_t mode) {
-    volatile uint8_t* ddr = get_ddr(pin);
-    if (!ddr) return;
-    uint8_t bit = get_bit(pin);
+    volatile uint8_t* base = get_base(pin);
+    if (!base) return;
 
-    if (mode == OUTPUT)
-        *ddr |= (1 << bit);
-    else
-        *ddr &= ~(1 << bit);
+    update_bits(base + 1, get_mask(pin), mode == OUTPUT);
 }
 
 /**
@@ -111,14 +86,10 @@ void pinMode(uint8_t pin, uint8_t mode) {
  * @param val  HIGH or LOW
  */
 void digitalWrite(uint8_t pin, uint8_t val) {
-    volatile uint8_t* port = get_port(pin);
-    if (!port) return;
-    uint8_t bit = get_bit(pin);
+    volatile uint8_t* base = get_base(pin);
+    if (!base) return;
 
-    if (val == HIGH)
-        *port |= (1 << bit);
-    else
-        *port &= ~(1 << bit);
+    update_bits(base + 2, get_mask(pin), val == HIGH);
 }
 
 /**
@@ -128,9 +99,8 @@ void digitalWrite(uint8_t pin, uint8_t val) {
  * @return     HIGH if logic level is 1, otherwise LOW
  */
 int digitalRead(uint8_t pin) {
-    volatile uint8_t* pin_reg = get_pin_reg(pin);
-    if (!pin_reg) return 0;
-    uint8_t bit = get_bit(pin);
+    volatile uint8_t* base = get_base(pin);
+    if (!base) return 0;
 
-    return (*pin_reg & (1 << bit)) ? HIGH : LOW;
+    return (*base & get_mask(pin)) ? HIGH : LOW;
 }
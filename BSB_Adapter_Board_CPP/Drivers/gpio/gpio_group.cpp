@@ -0,0 +1,115 @@
+#include "gpio_group.h"
+#include "gpio_pin.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+// -----------------------------------------------------------------------------
+// Planning
+// -----------------------------------------------------------------------------
+
+void PinGroup::begin(const uint8_t* pins, uint8_t count) {
+    _sliceCount = 0;
+    _count = 0;
+    if (!pins) return;
+    if (count > PIN_GROUP_MAX) count = PIN_GROUP_MAX;
+    _count = count;
+
+    for (uint8_t i = 0; i < count; ++i) {
+        uint8_t pin = pins[i];
+        _pinSlice[i] = 0xFF;
+        if (!gpioValidPin(pin)) continue;
+
+        volatile uint8_t* base = &_SFR_MEM8(gpioPortBase(pin >> 4));
+        uint8_t bit = pin & 0x07;
+        int8_t shift = (int8_t)bit - (int8_t)i;
+
+        // Find or open the slice of this port
+        uint8_t s = 0;
+        while (s < _sliceCount && _slices[s].base != base) ++s;
+        if (s == _sliceCount) {
+            _slices[s].base = base;
+            _slices[s].mask = 0;
+            _slices[s].shift = shift;
+            _slices[s].aligned = true;
+            _sliceCount++;
+        }
+        if (_slices[s].shift != shift) _slices[s].aligned = false;
+
+        _slices[s].mask |= (1 << bit);
+        _pinSlice[i] = s;
+        _pinMask[i] = (1 << bit);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Direction
+// -----------------------------------------------------------------------------
+
+void PinGroup::updateDdr(bool output) {
+    for (uint8_t s = 0; s < _sliceCount; ++s) {
+        volatile uint8_t* ddr = _slices[s].base + 1;
+        uint8_t sreg = SREG;
+        cli();
+        if (output) *ddr |= _slices[s].mask;
+        else        *ddr &= ~_slices[s].mask;
+        SREG = sreg;
+    }
+}
+
+void PinGroup::output() {
+    updateDdr(true);
+}
+
+void PinGroup::input() {
+    updateDdr(false);
+}
+
+// -----------------------------------------------------------------------------
+// Bus Access
+// -----------------------------------------------------------------------------
+
+void PinGroup::write(uint8_t value) {
+    uint8_t bits[PIN_GROUP_MAX];
+
+    for (uint8_t s = 0; s < _sliceCount; ++s) {
+        const Slice& slice = _slices[s];
+        if (!slice.aligned) {
+            bits[s] = 0;
+        } else if (slice.shift >= 0) {
+            bits[s] = value << slice.shift;
+        } else {
+            bits[s] = value >> -slice.shift;
+        }
+    }
+
+    // Scatter the bits of pins that do not line up with their port
+    for (uint8_t i = 0; i < _count; ++i) {
+        uint8_t s = _pinSlice[i];
+        if (s != 0xFF && !_slices[s].aligned && (value & (1 << i))) {
+            bits[s] |= _pinMask[i];
+        }
+    }
+
+    for (uint8_t s = 0; s < _sliceCount; ++s) {
+        volatile uint8_t* port = _slices[s].base + 2;
+        uint8_t mask = _slices[s].mask;
+        uint8_t sreg = SREG;
+        cli();
+        *port = (*port & ~mask) | (bits[s] & mask);
+        SREG = sreg;
+    }
+}
+
+uint8_t PinGroup::read() {
+    uint8_t ports[PIN_GROUP_MAX];
+    for (uint8_t s = 0; s < _sliceCount; ++s) {
+        ports[s] = *_slices[s].base;
+    }
+
+    uint8_t value = 0;
+    for (uint8_t i = 0; i < _count; ++i) {
+        uint8_t s = _pinSlice[i];
+        if (s != 0xFF && (ports[s] & _pinMask[i])) value |= (1 << i);
+    }
+    return value;
+}
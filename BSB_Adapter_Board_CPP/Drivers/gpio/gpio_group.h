@@ -0,0 +1,72 @@
+/*
+ * GPIO Pin Groups (Parallel Bus Access)
+ * -------------------------------------
+ *
+ * A PinGroup drives up to 8 AP* pins as one bus value: bit i of the value
+ * belongs to pins[i]. begin() plans the group once and sorts the pins into
+ * per-port slices:
+ *
+ *   - pins on one port whose bits line up with the value bits (e.g. D0-D7
+ *     on APH0-APH7) are written with a shift and one masked port store
+ *   - other pins are gathered into their port's mask bit by bit, still
+ *     one masked store per port
+ *
+ * Usage Example:
+ * --------------
+ *     static const uint8_t busPins[8] = { APH0, APH1, APH2, APH3,
+ *                                         APH4, APH5, APH6, APH7 };
+ *     PinGroup bus;
+ *     bus.begin(busPins, 8);
+ *     bus.output();
+ *     bus.write(0xA5);             // One read-modify-write of PORTH
+ */
+
+#ifndef GPIO_GROUP_H_
+#define GPIO_GROUP_H_
+
+#include <stdint.h>
+
+#define PIN_GROUP_MAX 8
+
+class PinGroup {
+public:
+    /**
+     * @brief Plans the group; invalid pins are skipped.
+     * @param pins   AP* pins, pins[i] carries bit i of the bus value
+     * @param count  Number of pins (1-PIN_GROUP_MAX)
+     */
+    void begin(const uint8_t* pins, uint8_t count);
+
+    void output();
+    void input();
+
+    /**
+     * @brief Drives all pins, one atomic masked store per port.
+     */
+    void write(uint8_t value);
+
+    /**
+     * @brief Samples all pins (one PINx read per port).
+     */
+    uint8_t read();
+
+    uint8_t portCount() { return _sliceCount; }  // 1 = single-port fast path
+
+private:
+    struct Slice {
+        volatile uint8_t* base;  // PINx (DDRx = +1, PORTx = +2)
+        uint8_t mask;            // Port bits owned by the group
+        int8_t  shift;           // Port bit = value bit + shift (if aligned)
+        bool    aligned;         // All pins follow shift
+    };
+
+    void updateDdr(bool output);
+
+    Slice   _slices[PIN_GROUP_MAX];
+    uint8_t _sliceCount = 0;
+    uint8_t _count = 0;
+    uint8_t _pinSlice[PIN_GROUP_MAX];   // Slice per value bit (0xFF = none)
+    uint8_t _pinMask[PIN_GROUP_MAX];    // Port bit per value bit
+};
+
+#endif /* GPIO_GROUP_H_ */
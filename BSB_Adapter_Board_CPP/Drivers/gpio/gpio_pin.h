@@ -0,0 +1,119 @@
+/*
+ * Compile-Time GPIO Pins for ATmega2560
+ * -------------------------------------
+ *
+ * Pin<APxx> resolves the port, DDR and PIN registers and the bit mask of
+ * an AP* pin at compile time, so each access compiles to one or two
+ * instructions instead of a call into gpio.cpp:
+ *
+ *     typedef Pin<APB7> Led;
+ *
+ *     Led::output();
+ *     Led::set();                  // sbi PORTB, 7
+ *     Led::toggle();               // sbi PINB, 7 (writing PINx toggles)
+ *     if (Pin<APD2>::read()) { }   // sbic PIND, 2
+ *
+ * Register addresses:
+ * -------------------
+ * The AP* encoding puts the port index in the upper nibble (pin >> 4):
+ *
+ *     A=0 B=1 C=2 D=3 E=4 F=5 G=6 H=7 J=8 K=9 L=10
+ *
+ * Each port is a PINx/DDRx/PORTx triple at consecutive data addresses.
+ * Ports A-G (0x20-0x34) lie in the low I/O space and get single-cycle
+ * sbi/cbi; ports H-L (0x100+) are only reachable with lds/sts, so their
+ * read-modify-write is wrapped in SREG/cli to stay atomic against ISRs.
+ *
+ * Cycle comparison (16 MHz, avr-gcc -Os; gpio.cpp figures vary with
+ * the pin, see gpioBenchmark() in tasks.cpp for measured values):
+ *
+ * | Operation              | gpio.cpp       | Pin<APB7> | Pin<APH3> |
+ * |------------------------|----------------|-----------|-----------|
+ * | digitalWrite / set()   | ~40-90 + call  |     2     |    ~8     |
+ * | toggle()               | read + write   |     2     |     3     |
+ * | digitalRead / read()   | ~35-85 + call  |   1-3     |     3     |
+ */
+
+#ifndef GPIO_PIN_H_
+#define GPIO_PIN_H_
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <stdint.h>
+#include "gpio.h"
+
+/**
+ * @brief Data-space address of PINx for a port index (pin >> 4), 0 if none.
+ * DDRx follows at +1 and PORTx at +2.
+ */
+constexpr uint16_t gpioPortBase(uint8_t port) {
+    return port <= 6  ? 0x20 + 3 * port :           // A-G
+           port <= 10 ? 0x100 + 3 * (port - 7) :    // H, J, K, L
+           0;
+}
+
+/**
+ * @brief True for an AP* value that names an existing pin.
+ */
+constexpr bool gpioValidPin(uint8_t pin) {
+    return (pin >> 4) <= 10 && (pin & 0x08) == 0 &&
+           !((pin >> 4) == 6 && (pin & 0x07) > 5);   // Port G has PG0-PG5
+}
+
+template <uint8_t P>
+class Pin {
+    static_assert(gpioValidPin(P), "Pin<>: not an ATmega2560 AP* pin");
+
+public:
+    static constexpr uint8_t mask = 1 << (P & 0x07);
+
+    static void output() { setBits(ddr()); }
+    static void input()  { clearBits(ddr()); }
+
+    static void set()    { setBits(port()); }
+    static void clear()  { clearBits(port()); }
+
+    static void write(bool value) {
+        if (value) set();
+        else       clear();
+    }
+
+    /**
+     * @brief Writing 1 to a PINx bit toggles PORTx: no read-modify-write.
+     */
+    static void toggle() { pin() = mask; }
+
+    static bool read()   { return (pin() & mask) != 0; }
+
+private:
+    static constexpr uint16_t base = gpioPortBase(P >> 4);
+    static constexpr bool lowIo = base < 0x40;        // sbi/cbi reachable
+
+    static volatile uint8_t& pin()  { return _SFR_MEM8(base); }
+    static volatile uint8_t& ddr()  { return _SFR_MEM8(base + 1); }
+    static volatile uint8_t& port() { return _SFR_MEM8(base + 2); }
+
+    static void setBits(volatile uint8_t& reg) {
+        if (lowIo) {
+            reg |= mask;                               // sbi
+        } else {
+            uint8_t sreg = SREG;
+            cli();
+            reg |= mask;                               // lds/ori/sts
+            SREG = sreg;
+        }
+    }
+
+    static void clearBits(volatile uint8_t& reg) {
+        if (lowIo) {
+            reg &= ~mask;                              // cbi
+        } else {
+            uint8_t sreg = SREG;
+            cli();
+            reg &= ~mask;                              // lds/andi/sts
+            SREG = sreg;
+        }
+    }
+};
+
+#endif /* GPIO_PIN_H_ */
@@ -1,6 +1,9 @@
 #include "lcd.h"
 #include <util/delay.h>
 #include "gpio.h"  // Your GPIO library
+#include <string.h>
+#include "postmortem.h"
+#include "metrics.h"
 
 #ifndef F_CPU
 #define F_CPU 16000000UL
@@ -14,12 +17,28 @@
 #define LCD_FUNCTIONSET   0x30
 #define LCD_2LINE         0x08
 #define LCD_SETDDRAMADDR  0x80
+#define LCD_BUSYFLAG      0x80
+
+// Busy flag polls before giving up (~2 us each, clear takes up to ~1.6 ms)
+#define LCD_BUSY_TIMEOUT  2000
+
+// Queued mode (one entry per service() slot, nominally 1 ms)
+#define LCD_POWERUP_MS    50    // Wait after power-up (ms / slots)
+#define LCD_Q_DATA        0x80  // RS = 1
+#define LCD_Q_WAIT        0x40  // value = empty slots to wait
+#define LCD_Q_NOPOLL      0x20  // Busy flag not valid yet (init sequence)
+#define LCD_Q_HOLD        0x0F  // Empty slots after the byte (timed waits)
+#define LCD_Q_SLOW_HOLD   3     // clear/home: 1.52 ms, slots may jitter
+#define LCD_BUSY_SLOTS    20    // Busy for this many slots: use timed waits
 
 // Updated constructor with RW
 LCD::LCD(uint8_t rs, uint8_t rw, uint8_t en,
 uint8_t d0, uint8_t d1, uint8_t d2, uint8_t d3,
 uint8_t d4, uint8_t d5, uint8_t d6, uint8_t d7)
-: _rs(rs), _rw(rw), _en(en), _cols(0), _rows(0) {
+: _rs(rs), _rw(rw), _en(en), _cols(0), _rows(0), _busyPoll(false),
+  _col(0), _row(0), _hwAddress(0xFF), _redraw(true),
+  _queued(false), _qHead(0), _qTail(0), _holdSlots(0), _busySlots(0),
+  _qDropped(0), _onComplete(0) {
 	_data_pins[0] = d0;
 	_data_pins[1] = d1;
 	_data_pins[2] = d2;
@@ -31,37 +50,62 @@ uint8_t d4, uint8_t d5, uint8_t d6, uint8_t d7)
 }
 
 void LCD::begin(uint8_t cols, uint8_t rows) {
+	if (cols > LCD_MAX_COLS) cols = LCD_MAX_COLS;
+	if (rows > LCD_MAX_ROWS) rows = LCD_MAX_ROWS;
 	_cols = cols;
 	_rows = rows;
+	_busyPoll = false;  // Busy flag is not valid before the function set
+	_qHead = _qTail = 0;
+	_holdSlots = 0;
 
 	setupPins();
 
-	_delay_ms(50);
+	if (_queued) {
+		// Same sequence, paced by service(): begin() returns at once
+		enqueue(LCD_POWERUP_MS, LCD_Q_WAIT);
+		enqueue(LCD_FUNCTIONSET | (_rows > 1 ? LCD_2LINE : 0x00), LCD_Q_NOPOLL);
+		enqueue(LCD_DISPLAYON, LCD_Q_NOPOLL);
+		enqueue(LCD_CLEARDISPLAY, LCD_Q_NOPOLL | LCD_Q_SLOW_HOLD);
+		enqueue(LCD_ENTRYMODESET, LCD_Q_NOPOLL);
+	} else {
+		_delay_ms(LCD_POWERUP_MS);
+
+		command(LCD_FUNCTIONSET | (_rows > 1 ? LCD_2LINE : 0x00));
+		command(LCD_DISPLAYON);
+		command(LCD_CLEARDISPLAY);
+		command(LCD_ENTRYMODESET);
+	}
+
+	// The glass is blank and the address counter is at 0
+	memset(_shadow, ' ', sizeof(_shadow));
+	memset(_glass, ' ', sizeof(_glass));
+	_col = 0;
+	_row = 0;
+	_hwAddress = 0;
+	_redraw = false;
 
-	command(LCD_FUNCTIONSET | (_rows > 1 ? LCD_2LINE : 0x00));
-	command(LCD_DISPLAYON);
-	command(LCD_CLEARDISPLAY);
-	command(LCD_ENTRYMODESET);
-	_delay_ms(2);
+	setBusyPolling(true);
+}
+
+void LCD::setBusyPolling(bool enable) {
+	_busyPoll = enable && _rw != 255;
 }
 
 void LCD::clear() {
-	command(LCD_CLEARDISPLAY);
-	_delay_ms(2);
+	memset(_shadow, ' ', sizeof(_shadow));
+	_col = 0;
+	_row = 0;
 }
 
 void LCD::home() {
-	command(LCD_RETURNHOME);
-	_delay_ms(2);
+	_col = 0;
+	_row = 0;
 }
 
 void LCD::setCursor(uint8_t col, uint8_t row) {
-	static const uint8_t row_offsets_2[] = {0x00, 0x40};
-	static const uint8_t row_offsets_4[] = {0x00, 0x40, 0x14, 0x54};
-	const uint8_t* offsets = (_rows > 2) ? row_offsets_4 : row_offsets_2;
-
 	if (row >= _rows) row = _rows - 1;
-	command(LCD_SETDDRAMADDR | (col + offsets[row]));
+	_col = col;
+	_row = row;
 }
 
 void LCD::print(const char* str) {
@@ -75,27 +119,221 @@ void LCD::print(char c) {
 }
 
 void LCD::command(uint8_t cmd) {
-	send(cmd, false);  // mode = 0 for command
+	bool slow = (cmd == LCD_CLEARDISPLAY || cmd == LCD_RETURNHOME);
+
+	if (_queued) {
+		// Dropped: the controller never saw it, so the model is unknown
+		if (!enqueue(cmd, slow ? LCD_Q_SLOW_HOLD : 0)) {
+			invalidate();
+			return;
+		}
+	} else {
+		send(cmd, false);  // mode = 0 for command
+		if (slow && !_busyPoll) _delay_ms(2);  // Otherwise the next access waits
+	}
+
+	// Keep the glass model in step with what the controller did
+	if (cmd == LCD_CLEARDISPLAY) memset(_glass, ' ', sizeof(_glass));
+	if (slow) {
+		_hwAddress = 0;
+	} else {
+		_hwAddress = 0xFF;
+	}
 }
 
 void LCD::write(uint8_t data) {
-	send(data, true);  // mode = 1 for data
+	// Characters past the end of the row are dropped
+	if (_row < _rows && _col < _cols) {
+		_shadow[_row][_col] = data;
+	}
+	if (_col < 0xFF) _col++;
+}
+
+uint8_t LCD::address(uint8_t col, uint8_t row) {
+	static const uint8_t row_offsets_2[] = {0x00, 0x40};
+	static const uint8_t row_offsets_4[] = {0x00, 0x40, 0x14, 0x54};
+	const uint8_t* offsets = (_rows > 2) ? row_offsets_4 : row_offsets_2;
+
+	return col + offsets[row];
+}
+
+uint8_t LCD::refresh() {
+	uint8_t transfers = 0;
+
+	for (uint8_t row = 0; row < _rows; row++) {
+		for (uint8_t col = 0; col < _cols; col++) {
+			uint8_t c = _shadow[row][col];
+			if (!_redraw && _glass[row][col] == c) continue;
+
+			// Queue full: the rest stays dirty for the next refresh()
+			if (_queued && queueFree() < 2) return transfers;
+
+			// The address counter auto-increments after each character
+			uint8_t addr = address(col, row);
+			if (_hwAddress != addr) {
+				command(LCD_SETDDRAMADDR | addr);
+				transfers++;
+			}
+
+			if (_queued) enqueue(c, LCD_Q_DATA);
+			else         send(c, true);  // mode = 1 for data
+			transfers++;
+			_glass[row][col] = c;
+			_hwAddress = addr + 1;
+		}
+	}
+
+	_redraw = false;
+	return transfers;
+}
+
+void LCD::invalidate() {
+	_redraw = true;
+	_hwAddress = 0xFF;
 }
 
 void LCD::send(uint8_t value, bool mode) {
+	if (_busyPoll) waitReady();
+	transfer(value, mode);
+	if (!_busyPoll) _delay_us(50);
+}
+
+void LCD::transfer(uint8_t value, bool mode) {
 	// Set RS
 	digitalWrite(_rs, mode);
 
 	// Set RW = 0 for write if used
 	if (_rw != 255) digitalWrite(_rw, 0);
 
-	// Set data lines
-	for (uint8_t i = 0; i < 8; i++) {
-		digitalWrite(_data_pins[i], (value >> i) & 0x01);
-	}
+	// Set data lines (one masked store per port)
+	_data.write(value);
 
 	pulseEnable();
-	_delay_us(50);
+	METRIC_INC(LCD_BYTES);
+}
+
+/**
+ * @brief Reads the HD44780 busy flag once.
+ *
+ * The data bus is released before RW goes high, so the controller and
+ * the MCU never drive D0-D7 at the same time.
+ */
+bool LCD::pollBusy() {
+	_data.input();
+	digitalWrite(_rs, 0);
+	digitalWrite(_rw, 1);
+
+	digitalWrite(_en, 1);
+	_delay_us(1);                     // tDDR (data delay) < 360 ns
+	bool busy = _data.read() & LCD_BUSYFLAG;
+	digitalWrite(_en, 0);
+	_delay_us(1);
+
+	digitalWrite(_rw, 0);
+	_data.output();
+	return busy;
+}
+
+/**
+ * @brief Waits until the busy flag clears. If it never does (display
+ * missing, RW not connected) the driver drops back to timed waits for good.
+ */
+void LCD::waitReady() {
+	uint16_t polls = 0;
+	bool busy;
+	do {
+		busy = pollBusy();
+	} while (busy && ++polls < LCD_BUSY_TIMEOUT);
+
+	if (busy) _busyPoll = false;
+}
+
+// -----------------------------------------------------------------------------
+// Command Queue
+// -----------------------------------------------------------------------------
+
+void LCD::setQueued(bool enable) {
+	if (!enable) flush();
+	_queued = enable;
+}
+
+uint8_t LCD::queueFree() {
+	return (LCD_QUEUE_SIZE - 1) - ((_qHead - _qTail) & (LCD_QUEUE_SIZE - 1));
+}
+
+bool LCD::enqueue(uint8_t value, uint8_t flags) {
+	if (queueFree() == 0) {
+		_qDropped++;
+		METRIC_INC(LCD_QUEUE_DROPS);
+		postmortem.log(PM_OVERFLOW, PM_SRC_LCD_QUEUE);
+		return false;
+	}
+	_queue[_qHead].value = value;
+	_queue[_qHead].flags = flags;
+	_qHead = (_qHead + 1) & (LCD_QUEUE_SIZE - 1);
+	METRIC_MAX(LCD_QUEUE_PEAK, (LCD_QUEUE_SIZE - 1) - queueFree());
+	return true;
+}
+
+/**
+ * @brief Runs one queue slot: at most one byte goes to the controller.
+ *
+ * Before a byte, a single busy flag read decides whether the controller
+ * is ready; if not, the byte waits for the next slot. Without polling
+ * (and during the init sequence) an entry's hold count keeps the
+ * following slots empty instead, which covers clear/home (1.52 ms).
+ * Ordinary bytes need 37 us, far less than one slot.
+ */
+void LCD::service() {
+	if (_holdSlots) {
+		_holdSlots--;
+		return;
+	}
+	if (_qHead == _qTail) return;
+
+	const Entry& e = _queue[_qTail];
+	bool timed = !_busyPoll || (e.flags & LCD_Q_NOPOLL);
+
+	if (e.flags & LCD_Q_WAIT) {
+		_holdSlots = e.value;
+	} else {
+		if (!timed) {
+			if (pollBusy()) {
+				if (++_busySlots >= LCD_BUSY_SLOTS) _busyPoll = false;
+				return;
+			}
+			_busySlots = 0;
+		}
+		transfer(e.value, e.flags & LCD_Q_DATA);
+		if (timed) _holdSlots = e.flags & LCD_Q_HOLD;
+	}
+
+	_qTail = (_qTail + 1) & (LCD_QUEUE_SIZE - 1);
+	if (_qHead == _qTail && _onComplete) _onComplete();
+}
+
+/**
+ * @brief Sends everything still queued, blocking.
+ */
+void LCD::flush() {
+	while (_qHead != _qTail) {
+		const Entry& e = _queue[_qTail];
+		uint8_t hold = e.flags & LCD_Q_HOLD;
+
+		if (e.flags & LCD_Q_WAIT) {
+			hold = e.value;
+		} else if (e.flags & LCD_Q_NOPOLL) {
+			transfer(e.value, e.flags & LCD_Q_DATA);
+			_delay_us(50);
+		} else {
+			send(e.value, e.flags & LCD_Q_DATA);
+			if (_busyPoll) hold = 0;
+		}
+		while (hold--) _delay_ms(1);
+
+		_qTail = (_qTail + 1) & (LCD_QUEUE_SIZE - 1);
+	}
+	_holdSlots = 0;
 }
 
 void LCD::pulseEnable() {
@@ -110,9 +348,8 @@ void LCD::setupPins() {
 	pinMode(_en, 1);
 	if (_rw != 255) pinMode(_rw, 1);  // Output mode only if RW is used
 
-	for (uint8_t i = 0; i < 8; i++) {
-		pinMode(_data_pins[i], 1);
-	}
+	_data.begin(_data_pins, 8);
+	_data.output();
 }
 
 // Optional wrappers
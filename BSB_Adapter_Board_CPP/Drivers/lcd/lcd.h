@@ -2,10 +2,28 @@
 #define LCD_H_
 
 #include <stdint.h>
+#include "gpio_group.h"
+
+#define LCD_MAX_COLS 20
+#define LCD_MAX_ROWS 4
+#define LCD_QUEUE_SIZE 64   // Power of two; a full 16x2 redraw is 34 entries
 
 /**
  * @brief Arduino-style LCD class using 8-bit mode.
  * Works like LiquidCrystal, but implemented using your own GPIO functions.
+ *
+ * clear(), home(), setCursor(), print() and write() only draw into a RAM
+ * shadow of the display. refresh() compares the shadow with what was last
+ * sent to the glass and transfers only the changed cells; a cursor
+ * address command is sent only where the changed cells are not
+ * contiguous. A status line whose counter changes by one digit costs
+ * one address command and one character instead of a full line.
+ *
+ * Queued mode (setQueued(true) before begin()): begin(), refresh() and
+ * command() only fill a command ring and return within microseconds.
+ * service(), run from a 1 ms scheduler task, sends at most one byte per
+ * call and keeps the HD44780 timing through the busy flag or slot holds.
+ * A refresh that does not fit the ring is finished by the next one.
  */
 class LCD {
 public:
@@ -31,11 +49,64 @@ public:
   void setCursor(uint8_t col, uint8_t row);
   void print(const char* str);
   void print(char c);
-  void command(uint8_t cmd);
+  void command(uint8_t cmd);          // Sent immediately, bypasses the shadow
   void write(uint8_t data);
 
+  /**
+   * @brief Sends the cells that differ from the glass.
+   * @return Number of bus transfers (characters + address commands)
+   */
+  uint8_t refresh();
+
+  /**
+   * @brief Forgets the glass contents: the next refresh() redraws everything.
+   */
+  void invalidate();
+
+  /**
+   * @brief Switches between blocking and queued transfers.
+   * Leaving queued mode sends the remaining entries (blocking).
+   */
+  void setQueued(bool enable);
+  bool queued() { return _queued; }
+
+  /**
+   * @brief Sends at most one queued byte; call every 1 ms in queued mode.
+   */
+  void service();
+
+  bool idle() { return _qHead == _qTail && _holdSlots == 0; }
+  uint16_t dropped() { return _qDropped; }   // Entries lost to a full ring
+
+  /**
+   * @brief Called from service() each time the ring runs empty.
+   */
+  void setCompletionHandler(void (*handler)()) { _onComplete = handler; }
+
+  /**
+   * @brief Selects how the driver waits for the controller.
+   * @param enable true  = poll the busy flag (D7) over RW before each access
+   *               false = fixed delays (50 us per access, 2 ms clear/home)
+   * Polling is the default once begin() finishes, if RW is wired. With
+   * rw == 255 the timed waits are always used.
+   */
+  void setBusyPolling(bool enable);
+  bool busyPolling() { return _busyPoll; }
+
 private:
+  struct Entry {
+    uint8_t value;
+    uint8_t flags;
+  };
+
   void send(uint8_t value, bool mode);
+  void transfer(uint8_t value, bool mode);
+  bool pollBusy();
+  void waitReady();
+  bool enqueue(uint8_t value, uint8_t flags);
+  uint8_t queueFree();
+  void flush();
+  uint8_t address(uint8_t col, uint8_t row);
   void pulseEnable();
   void setupPins();
   void digitalWriteFast(uint8_t pin, uint8_t val);
@@ -43,7 +114,23 @@ private:
 
   uint8_t _rs, _rw, _en;
   uint8_t _data_pins[8];
+  PinGroup _data;          // D0-D7 as one bus (single PORTH store on this board)
   uint8_t _cols, _rows;
+  bool _busyPoll;
+
+  uint8_t _shadow[LCD_MAX_ROWS][LCD_MAX_COLS];  // Wanted contents
+  uint8_t _glass[LCD_MAX_ROWS][LCD_MAX_COLS];   // Last sent contents
+  uint8_t _col, _row;                           // Shadow cursor
+  uint8_t _hwAddress;                           // DDRAM address counter, 0xFF = unknown
+  bool _redraw;                                 // Glass contents unknown
+
+  bool _queued;
+  Entry _queue[LCD_QUEUE_SIZE];
+  uint8_t _qHead, _qTail;
+  uint8_t _holdSlots;                           // Slots to skip before the next entry
+  uint8_t _busySlots;                           // Consecutive slots found busy
+  uint16_t _qDropped;
+  void (*_onComplete)();
 };
 
 #endif
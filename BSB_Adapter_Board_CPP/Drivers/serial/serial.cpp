@@ -1,6 +1,8 @@
 #include "serial.h"
 #include <avr/io.h>
 #include <stdlib.h>  // for itoa
+#include "trace.h"
+#include "metrics.h"
 
 #ifndef F_CPU
 #define F_CPU 16000000UL
@@ -34,28 +36,60 @@ void SerialClass::begin(uint32_t baudrate) {
 	}
 }
 
+// Clears TXCn (write 1) while keeping U2Xn/MPCMn; FEn, DORn, UPEn must be written 0
+#define TXC_CLEAR(reg, txc, u2x, mpcm) reg = (reg & ((1 << u2x) | (1 << mpcm))) | (1 << txc)
+
 void SerialClass::write(uint8_t data) {
 	if (this == &Serial) {
 		while (!(UCSR0A & (1 << UDRE0)));
+		TXC_CLEAR(UCSR0A, TXC0, U2X0, MPCM0);
 		UDR0 = data;
 		} else if (this == &Serial1) {
 		while (!(UCSR1A & (1 << UDRE1)));
+		TXC_CLEAR(UCSR1A, TXC1, U2X1, MPCM1);
 		UDR1 = data;
 		} else if (this == &Serial2) {
 		while (!(UCSR2A & (1 << UDRE2)));
+		TXC_CLEAR(UCSR2A, TXC2, U2X2, MPCM2);
 		UDR2 = data;
 		} else if (this == &Serial3) {
 		while (!(UCSR3A & (1 << UDRE3)));
+		TXC_CLEAR(UCSR3A, TXC3, U2X3, MPCM3);
 		UDR3 = data;
 	}
+	_txStarted = true;
+	TRACE_UART_TX_EVT(data);
+	METRIC_INC(UART_TX_BYTES);
+}
+
+bool SerialClass::writeReady() {
+	if (this == &Serial)  return UCSR0A & (1 << UDRE0);
+	if (this == &Serial1) return UCSR1A & (1 << UDRE1);
+	if (this == &Serial2) return UCSR2A & (1 << UDRE2);
+	if (this == &Serial3) return UCSR3A & (1 << UDRE3);
+	return false;
+}
+
+bool SerialClass::txBusy() {
+	if (!_txStarted) return false;
+	if (this == &Serial)  return !(UCSR0A & (1 << TXC0));
+	if (this == &Serial1) return !(UCSR1A & (1 << TXC1));
+	if (this == &Serial2) return !(UCSR2A & (1 << TXC2));
+	if (this == &Serial3) return !(UCSR3A & (1 << TXC3));
+	return false;
 }
 
 int SerialClass::read() {
-	if (this == &Serial && (UCSR0A & (1 << RXC0))) return UDR0;
-	if (this == &Serial1 && (UCSR1A & (1 << RXC1))) return UDR1;
-	if (this == &Serial2 && (UCSR2A & (1 << RXC2))) return UDR2;
-	if (this == &Serial3 && (UCSR3A & (1 << RXC3))) return UDR3;
-	return -1;
+	int data = -1;
+	if (this == &Serial && (UCSR0A & (1 << RXC0))) data = UDR0;
+	if (this == &Serial1 && (UCSR1A & (1 << RXC1))) data = UDR1;
+	if (this == &Serial2 && (UCSR2A & (1 << RXC2))) data = UDR2;
+	if (this == &Serial3 && (UCSR3A & (1 << RXC3))) data = UDR3;
+	if (data >= 0) {
+		TRACE_UART_RX_EVT(data);
+		METRIC_INC(UART_RX_BYTES);
+	}
+	return data;
 }
 
 bool SerialClass::available() {
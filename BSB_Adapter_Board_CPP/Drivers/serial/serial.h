@@ -15,6 +15,20 @@ class SerialClass {
 
 	void print(int value);
 	void println(int value);
+
+	/**
+	 * @brief True while a byte is still being shifted out (TXCn not set yet).
+	 * Sleep modes that halt clkIO must not be entered while this is true.
+	 */
+	bool txBusy();
+
+	/**
+	 * @brief True if write() can take a byte without waiting (UDREn set).
+	 */
+	bool writeReady();
+
+	private:
+	bool _txStarted = false;  // Any byte written since begin()
 };
 
 extern SerialClass Serial;
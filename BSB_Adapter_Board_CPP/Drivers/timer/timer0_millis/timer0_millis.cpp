@@ -2,7 +2,7 @@
 #include <avr/io.h>
 #include <avr/interrupt.h>
 #include "gpio.h"      // Required for pinMode() and digitalWrite()
-#include "serial.h"    // Serialx functions
+#include "log.h"       // Non-blocking, compiled out above LOG_LEVEL
 
 #ifndef F_CPU
 #define F_CPU 16000000UL
@@ -70,7 +70,7 @@ void blink(uint8_t pin, uint16_t on_time, uint16_t off_time)
         digitalWrite(pin, HIGH);         // Turn ON
         state = true;
         last_toggle_time = now;
-        Serial3.println("BSB_Adapter_Platine MCU luft...!");
+        LOG_DEBUG(BOARD, "BSB_Adapter_Platine MCU luft...!");
     }
 }
 
@@ -99,6 +99,6 @@ void Blink::update()
         digitalWrite(_pin, LOW);    // Turn ON
         _state = true;
         _last_toggle_time = now;
-        Serial3.println("BSB_Adapter_Platine MCU sich bewegt...!");
+        LOG_DEBUG(BOARD, "BSB_Adapter_Platine MCU sich bewegt...!");
     }
 }
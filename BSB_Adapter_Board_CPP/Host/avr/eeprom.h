@@ -0,0 +1,22 @@
+/*
+ * EEPROM access for the host build. Backed by hostEeprom(); a write
+ * keeps the EEPROM busy for HOST_EEPROM_WRITE_US of simulated time.
+ */
+
+#ifndef HOST_AVR_EEPROM_H_
+#define HOST_AVR_EEPROM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define EEMEM
+
+bool    eeprom_is_ready(void);
+void    eeprom_busy_wait(void);
+uint8_t eeprom_read_byte(const uint8_t* addr);
+void    eeprom_write_byte(uint8_t* addr, uint8_t value);
+void    eeprom_update_byte(uint8_t* addr, uint8_t value);
+void    eeprom_read_block(void* dst, const void* src, size_t n);
+void    eeprom_update_block(const void* src, void* dst, size_t n);
+
+#endif /* HOST_AVR_EEPROM_H_ */
@@ -0,0 +1,43 @@
+/*
+ * Interrupt support for the host build (see host_sim.h).
+ *
+ * ISR(vector) defines an ordinary extern "C" function under the
+ * ATmega2560 vector name; the simulator calls it when the flag and
+ * enable bit are set and SREG.I allows it.
+ */
+
+#ifndef HOST_AVR_INTERRUPT_H_
+#define HOST_AVR_INTERRUPT_H_
+
+#include <avr/io.h>
+
+#define WDT_vect           __vector_12
+#define TIMER1_COMPA_vect  __vector_17
+#define TIMER1_COMPB_vect  __vector_18
+#define TIMER1_OVF_vect    __vector_20
+#define TIMER0_COMPA_vect  __vector_21
+#define TIMER0_COMPB_vect  __vector_22
+#define TIMER0_OVF_vect    __vector_23
+#define USART0_RX_vect     __vector_25
+#define USART0_UDRE_vect   __vector_26
+#define ADC_vect           __vector_29
+#define USART1_RX_vect     __vector_36
+#define USART1_UDRE_vect   __vector_37
+#define USART2_RX_vect     __vector_51
+#define USART2_UDRE_vect   __vector_52
+#define USART3_RX_vect     __vector_54
+#define USART3_UDRE_vect   __vector_55
+
+// Attributes have no meaning on the host
+#define ISR_BLOCK
+#define ISR_NOBLOCK
+#define ISR_NAKED
+
+#define ISR(vector, ...) \
+    extern "C" void vector(void); \
+    extern "C" void vector(void)
+
+void cli(void);
+void sei(void);
+
+#endif /* HOST_AVR_INTERRUPT_H_ */
@@ -0,0 +1,379 @@
+/*
+ * ATmega2560 register map for the host build (see host_sim.h).
+ *
+ * Named registers are proxies: reading or writing one goes through
+ * hostRead8()/hostWrite8(), which applies the peripheral side effects
+ * (write-one-to-clear flags, ADSC, UDRn) and lets HOST_REG_CYCLES of
+ * simulated time pass. _SFR_MEM8() is the raw register file for code
+ * that computes port addresses.
+ */
+
+#ifndef HOST_AVR_IO_H_
+#define HOST_AVR_IO_H_
+
+#ifndef __cplusplus
+#error "The host register map needs C++ (register proxies)"
+#endif
+
+#include <stdint.h>
+#include "host_sim.h"
+
+class HostReg8 {
+public:
+    explicit HostReg8(uint16_t addr) : _addr(addr) {}
+
+    operator uint8_t() const { return hostRead8(_addr); }
+
+    HostReg8& operator=(uint8_t value) { hostWrite8(_addr, value); return *this; }
+    HostReg8& operator=(const HostReg8& other) { return *this = (uint8_t)other; }
+
+    // Read-modify-write, like IN/OR/OUT on the hardware
+    HostReg8& operator|=(uint8_t value) { return *this = (uint8_t)(hostRead8(_addr) | value); }
+    HostReg8& operator&=(uint8_t value) { return *this = (uint8_t)(hostRead8(_addr) & value); }
+    HostReg8& operator^=(uint8_t value) { return *this = (uint8_t)(hostRead8(_addr) ^ value); }
+    HostReg8& operator+=(uint8_t value) { return *this = (uint8_t)(hostRead8(_addr) + value); }
+    HostReg8& operator-=(uint8_t value) { return *this = (uint8_t)(hostRead8(_addr) - value); }
+
+private:
+    uint16_t _addr;
+};
+
+/**
+ * 16-bit pair: low byte read first and high byte written first, as the
+ * TEMP register requires on the hardware.
+ */
+class HostReg16 {
+public:
+    explicit HostReg16(uint16_t addr) : _addr(addr) {}
+
+    operator uint16_t() const {
+        uint8_t low = hostRead8(_addr);
+        return low | ((uint16_t)hostRead8(_addr + 1) << 8);
+    }
+
+    HostReg16& operator=(uint16_t value) {
+        hostWrite8(_addr + 1, value >> 8);
+        hostWrite8(_addr, value & 0xFF);
+        return *this;
+    }
+    HostReg16& operator=(const HostReg16& other) { return *this = (uint16_t)other; }
+    HostReg16& operator+=(uint16_t value) { return *this = (uint16_t)(*this + value); }
+    HostReg16& operator-=(uint16_t value) { return *this = (uint16_t)(*this - value); }
+
+private:
+    uint16_t _addr;
+};
+
+#define _SFR_MEM8(addr)   (hostRegs[(addr)])
+#define _SFR_MEM16(addr)  HostReg16(addr)
+#define _BV(bit)          (1 << (bit))
+#define bit_is_set(reg, bit)    ((reg) & _BV(bit))
+#define bit_is_clear(reg, bit)  (!((reg) & _BV(bit)))
+
+// -----------------------------------------------------------------------------
+// GPIO
+// -----------------------------------------------------------------------------
+
+#define PINA    HostReg8(0x20)
+#define DDRA    HostReg8(0x21)
+#define PORTA   HostReg8(0x22)
+#define PINB    HostReg8(0x23)
+#define DDRB    HostReg8(0x24)
+#define PORTB   HostReg8(0x25)
+#define PINC    HostReg8(0x26)
+#define DDRC    HostReg8(0x27)
+#define PORTC   HostReg8(0x28)
+#define PIND    HostReg8(0x29)
+#define DDRD    HostReg8(0x2A)
+#define PORTD   HostReg8(0x2B)
+#define PINE    HostReg8(0x2C)
+#define DDRE    HostReg8(0x2D)
+#define PORTE   HostReg8(0x2E)
+#define PINF    HostReg8(0x2F)
+#define DDRF    HostReg8(0x30)
+#define PORTF   HostReg8(0x31)
+#define PING    HostReg8(0x32)
+#define DDRG    HostReg8(0x33)
+#define PORTG   HostReg8(0x34)
+#define PINH    HostReg8(0x100)
+#define DDRH    HostReg8(0x101)
+#define PORTH   HostReg8(0x102)
+#define PINJ    HostReg8(0x103)
+#define DDRJ    HostReg8(0x104)
+#define PORTJ   HostReg8(0x105)
+#define PINK    HostReg8(0x106)
+#define DDRK    HostReg8(0x107)
+#define PORTK   HostReg8(0x108)
+#define PINL    HostReg8(0x109)
+#define DDRL    HostReg8(0x10A)
+#define PORTL   HostReg8(0x10B)
+
+// -----------------------------------------------------------------------------
+// Core, sleep, EEPROM, watchdog
+// -----------------------------------------------------------------------------
+
+#define EECR    HostReg8(0x3F)
+#define EEDR    HostReg8(0x40)
+#define EEAR    HostReg16(0x41)
+#define SMCR    HostReg8(0x53)
+#define MCUSR   HostReg8(0x54)
+#define MCUCR   HostReg8(0x55)
+#define SREG    HostReg8(0x5F)
+#define WDTCSR  HostReg8(0x60)
+
+#define SREG_I  7
+
+// EECR
+#define EEPM1   5
+#define EEPM0   4
+#define EERIE   3
+#define EEMPE   2
+#define EEPE    1
+#define EERE    0
+
+// SMCR
+#define SM2     3
+#define SM1     2
+#define SM0     1
+#define SE      0
+
+// MCUSR
+#define JTRF    4
+#define WDRF    3
+#define BORF    2
+#define EXTRF   1
+#define PORF    0
+
+// WDTCSR
+#define WDIF    7
+#define WDIE    6
+#define WDP3    5
+#define WDCE    4
+#define WDE     3
+#define WDP2    2
+#define WDP1    1
+#define WDP0    0
+
+// -----------------------------------------------------------------------------
+// Timer0 / Timer1
+// -----------------------------------------------------------------------------
+
+#define TIFR0   HostReg8(0x35)
+#define TIFR1   HostReg8(0x36)
+#define TCCR0A  HostReg8(0x44)
+#define TCCR0B  HostReg8(0x45)
+#define TCNT0   HostReg8(0x46)
+#define OCR0A   HostReg8(0x47)
+#define OCR0B   HostReg8(0x48)
+#define TIMSK0  HostReg8(0x6E)
+#define TIMSK1  HostReg8(0x6F)
+#define TCCR1A  HostReg8(0x80)
+#define TCCR1B  HostReg8(0x81)
+#define TCCR1C  HostReg8(0x82)
+#define TCNT1   HostReg16(0x84)
+#define ICR1    HostReg16(0x86)
+#define OCR1A   HostReg16(0x88)
+#define OCR1B   HostReg16(0x8A)
+
+// TCCR0A / TCCR0B
+#define COM0A1  7
+#define COM0A0  6
+#define COM0B1  5
+#define COM0B0  4
+#define WGM01   1
+#define WGM00   0
+#define FOC0A   7
+#define FOC0B   6
+#define WGM02   3
+#define CS02    2
+#define CS01    1
+#define CS00    0
+
+// TIMSK0 / TIFR0
+#define OCIE0B  2
+#define OCIE0A  1
+#define TOIE0   0
+#define OCF0B   2
+#define OCF0A   1
+#define TOV0    0
+
+// TCCR1A / TCCR1B
+#define COM1A1  7
+#define COM1A0  6
+#define COM1B1  5
+#define COM1B0  4
+#define WGM11   1
+#define WGM10   0
+#define ICNC1   7
+#define ICES1   6
+#define WGM13   4
+#define WGM12   3
+#define CS12    2
+#define CS11    1
+#define CS10    0
+
+// TIMSK1 / TIFR1
+#define ICIE1   5
+#define OCIE1C  3
+#define OCIE1B  2
+#define OCIE1A  1
+#define TOIE1   0
+#define ICF1    5
+#define OCF1C   3
+#define OCF1B   2
+#define OCF1A   1
+#define TOV1    0
+
+// -----------------------------------------------------------------------------
+// ADC
+// -----------------------------------------------------------------------------
+
+#define ADCW    HostReg16(0x78)
+#define ADC     HostReg16(0x78)
+#define ADCL    HostReg8(0x78)
+#define ADCH    HostReg8(0x79)
+#define ADCSRA  HostReg8(0x7A)
+#define ADCSRB  HostReg8(0x7B)
+#define ADMUX   HostReg8(0x7C)
+#define DIDR2   HostReg8(0x7D)
+#define DIDR0   HostReg8(0x7E)
+
+// ADCSRA
+#define ADEN    7
+#define ADSC    6
+#define ADATE   5
+#define ADIF    4
+#define ADIE    3
+#define ADPS2   2
+#define ADPS1   1
+#define ADPS0   0
+
+// ADCSRB
+#define ACME    6
+#define MUX5    3
+#define ADTS2   2
+#define ADTS1   1
+#define ADTS0   0
+
+// ADMUX
+#define REFS1   7
+#define REFS0   6
+#define ADLAR   5
+#define MUX4    4
+#define MUX3    3
+#define MUX2    2
+#define MUX1    1
+#define MUX0    0
+
+// -----------------------------------------------------------------------------
+// USART0-3 (UCSRnA, UCSRnB, UCSRnC, -, UBRRnL, UBRRnH, UDRn)
+// -----------------------------------------------------------------------------
+
+#define UCSR0A  HostReg8(0xC0)
+#define UCSR0B  HostReg8(0xC1)
+#define UCSR0C  HostReg8(0xC2)
+#define UBRR0   HostReg16(0xC4)
+#define UBRR0L  HostReg8(0xC4)
+#define UBRR0H  HostReg8(0xC5)
+#define UDR0    HostReg8(0xC6)
+#define UCSR1A  HostReg8(0xC8)
+#define UCSR1B  HostReg8(0xC9)
+#define UCSR1C  HostReg8(0xCA)
+#define UBRR1   HostReg16(0xCC)
+#define UBRR1L  HostReg8(0xCC)
+#define UBRR1H  HostReg8(0xCD)
+#define UDR1    HostReg8(0xCE)
+#define UCSR2A  HostReg8(0xD0)
+#define UCSR2B  HostReg8(0xD1)
+#define UCSR2C  HostReg8(0xD2)
+#define UBRR2   HostReg16(0xD4)
+#define UBRR2L  HostReg8(0xD4)
+#define UBRR2H  HostReg8(0xD5)
+#define UDR2    HostReg8(0xD6)
+#define UCSR3A  HostReg8(0x130)
+#define UCSR3B  HostReg8(0x131)
+#define UCSR3C  HostReg8(0x132)
+#define UBRR3   HostReg16(0x134)
+#define UBRR3L  HostReg8(0x134)
+#define UBRR3H  HostReg8(0x135)
+#define UDR3    HostReg8(0x136)
+
+// UCSRnA
+#define RXC0    7
+#define TXC0    6
+#define UDRE0   5
+#define FE0     4
+#define DOR0    3
+#define UPE0    2
+#define U2X0    1
+#define MPCM0   0
+#define RXC1    7
+#define TXC1    6
+#define UDRE1   5
+#define FE1     4
+#define DOR1    3
+#define UPE1    2
+#define U2X1    1
+#define MPCM1   0
+#define RXC2    7
+#define TXC2    6
+#define UDRE2   5
+#define FE2     4
+#define DOR2    3
+#define UPE2    2
+#define U2X2    1
+#define MPCM2   0
+#define RXC3    7
+#define TXC3    6
+#define UDRE3   5
+#define FE3     4
+#define DOR3    3
+#define UPE3    2
+#define U2X3    1
+#define MPCM3   0
+
+// UCSRnB
+#define RXCIE0  7
+#define TXCIE0  6
+#define UDRIE0  5
+#define RXEN0   4
+#define TXEN0   3
+#define UCSZ02  2
+#define RXCIE1  7
+#define TXCIE1  6
+#define UDRIE1  5
+#define RXEN1   4
+#define TXEN1   3
+#define UCSZ12  2
+#define RXCIE2  7
+#define TXCIE2  6
+#define UDRIE2  5
+#define RXEN2   4
+#define TXEN2   3
+#define UCSZ22  2
+#define RXCIE3  7
+#define TXCIE3  6
+#define UDRIE3  5
+#define RXEN3   4
+#define TXEN3   3
+#define UCSZ32  2
+
+// UCSRnC
+#define UCSZ01  2
+#define UCSZ00  1
+#define UCSZ11  2
+#define UCSZ10  1
+#define UCSZ21  2
+#define UCSZ20  1
+#define UCSZ31  2
+#define UCSZ30  1
+
+// -----------------------------------------------------------------------------
+// Memory
+// -----------------------------------------------------------------------------
+
+#define RAMSTART  0x200
+#define RAMEND    0x21FF
+#define E2END     0x0FFF
+
+#endif /* HOST_AVR_IO_H_ */
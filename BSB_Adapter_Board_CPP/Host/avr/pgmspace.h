@@ -0,0 +1,30 @@
+/*
+ * Program memory access for the host build: flash and RAM share one
+ * address space, so PROGMEM data is read directly.
+ */
+
+#ifndef HOST_AVR_PGMSPACE_H_
+#define HOST_AVR_PGMSPACE_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P   const char*
+#define PSTR(s) (s)
+
+#define pgm_read_byte(addr)   (*(const uint8_t*)(addr))
+#define pgm_read_word(addr)   (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr)  (*(const uint32_t*)(addr))
+#define pgm_read_ptr(addr)    (*(void* const*)(addr))
+
+#define memcpy_P     memcpy
+#define strcpy_P     strcpy
+#define strncpy_P    strncpy
+#define strcmp_P     strcmp
+#define strlen_P     strlen
+#define snprintf_P   snprintf
+#define vsnprintf_P  vsnprintf
+
+#endif /* HOST_AVR_PGMSPACE_H_ */
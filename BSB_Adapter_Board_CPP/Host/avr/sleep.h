@@ -0,0 +1,28 @@
+/*
+ * Sleep modes for the host build. sleep_cpu() lets simulated time pass
+ * until an interrupt is taken; in ADC noise reduction mode Timer0/1 and
+ * the USARTs stop (clkIO halted) and an idle ADC starts converting.
+ */
+
+#ifndef HOST_AVR_SLEEP_H_
+#define HOST_AVR_SLEEP_H_
+
+#include <avr/io.h>
+
+#define SLEEP_MODE_IDLE        0
+#define SLEEP_MODE_ADC         _BV(SM0)
+#define SLEEP_MODE_PWR_DOWN    _BV(SM1)
+#define SLEEP_MODE_PWR_SAVE    (_BV(SM0) | _BV(SM1))
+#define SLEEP_MODE_STANDBY     (_BV(SM1) | _BV(SM2))
+#define SLEEP_MODE_EXT_STANDBY (_BV(SM0) | _BV(SM1) | _BV(SM2))
+
+#define set_sleep_mode(mode) \
+    (SMCR = (SMCR & ~(_BV(SM0) | _BV(SM1) | _BV(SM2))) | (mode))
+#define sleep_enable()   (SMCR |= _BV(SE))
+#define sleep_disable()  (SMCR &= ~_BV(SE))
+
+void sleep_cpu(void);
+
+#define sleep_mode() do { sleep_enable(); sleep_cpu(); sleep_disable(); } while (0)
+
+#endif /* HOST_AVR_SLEEP_H_ */
@@ -0,0 +1,30 @@
+/*
+ * Watchdog control for the host build (see host_sim.h).
+ */
+
+#ifndef HOST_AVR_WDT_H_
+#define HOST_AVR_WDT_H_
+
+#include <avr/io.h>
+
+#define WDTO_15MS   0
+#define WDTO_30MS   1
+#define WDTO_60MS   2
+#define WDTO_120MS  3
+#define WDTO_250MS  4
+#define WDTO_500MS  5
+#define WDTO_1S     6
+#define WDTO_2S     7
+#define WDTO_4S     8
+#define WDTO_8S     9
+
+void wdt_reset(void);
+
+#define wdt_enable(timeout) \
+    (WDTCSR = _BV(WDCE) | _BV(WDE), \
+     WDTCSR = _BV(WDE) | ((timeout) & 0x07) | (((timeout) & 0x08) ? _BV(WDP3) : 0))
+
+#define wdt_disable() \
+    (MCUSR &= ~_BV(WDRF), WDTCSR = _BV(WDCE) | _BV(WDE), WDTCSR = 0)
+
+#endif /* HOST_AVR_WDT_H_ */
@@ -0,0 +1,739 @@
+#include "host_sim.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/eeprom.h>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+#include <util/delay.h>
+#include <stdlib.h>
+#include <string.h>
+#include <deque>
+
+volatile uint8_t hostRegs[HOST_REG_SPACE];
+
+// Vectors the firmware may or may not define (null when absent)
+extern "C" {
+void WDT_vect(void) __attribute__((weak));
+void TIMER1_COMPA_vect(void) __attribute__((weak));
+void TIMER1_COMPB_vect(void) __attribute__((weak));
+void TIMER1_OVF_vect(void) __attribute__((weak));
+void TIMER0_COMPA_vect(void) __attribute__((weak));
+void TIMER0_COMPB_vect(void) __attribute__((weak));
+void TIMER0_OVF_vect(void) __attribute__((weak));
+void ADC_vect(void) __attribute__((weak));
+}
+
+namespace {
+
+const uint64_t NEVER = UINT64_MAX;
+
+// Data-space addresses (the names in <avr/io.h> are proxies)
+const uint16_t R_TIFR0  = 0x35;
+const uint16_t R_TIFR1  = 0x36;
+const uint16_t R_TCCR0A = 0x44;
+const uint16_t R_TCCR0B = 0x45;
+const uint16_t R_TCNT0  = 0x46;
+const uint16_t R_OCR0A  = 0x47;
+const uint16_t R_OCR0B  = 0x48;
+const uint16_t R_SMCR   = 0x53;
+const uint16_t R_MCUSR  = 0x54;
+const uint16_t R_SREG   = 0x5F;
+const uint16_t R_WDTCSR = 0x60;
+const uint16_t R_TIMSK0 = 0x6E;
+const uint16_t R_TIMSK1 = 0x6F;
+const uint16_t R_ADCL   = 0x78;
+const uint16_t R_ADCH   = 0x79;
+const uint16_t R_ADCSRA = 0x7A;
+const uint16_t R_ADCSRB = 0x7B;
+const uint16_t R_ADMUX  = 0x7C;
+const uint16_t R_TCCR1A = 0x80;
+const uint16_t R_TCCR1B = 0x81;
+const uint16_t R_TCNT1  = 0x84;
+const uint16_t R_ICR1   = 0x86;
+const uint16_t R_OCR1A  = 0x88;
+const uint16_t R_OCR1B  = 0x8A;
+
+const uint16_t uartBase[HOST_UART_COUNT] = { 0xC0, 0xC8, 0xD0, 0x130 };
+
+// Offsets within a USART block
+const uint8_t U_UCSRA = 0;
+const uint8_t U_UCSRB = 1;
+const uint8_t U_UCSRC = 2;
+const uint8_t U_UBRRL = 4;
+const uint8_t U_UBRRH = 5;
+const uint8_t U_UDR   = 6;
+
+// ADC auto trigger sources (ADTS2:0)
+const uint8_t TRIG_FREE_RUNNING = 0;
+const uint8_t TRIG_TIMER0_COMPA = 3;
+const uint8_t TRIG_TIMER0_OVF   = 4;
+const uint8_t TRIG_TIMER1_COMPB = 5;
+const uint8_t TRIG_TIMER1_OVF   = 6;
+
+const uint8_t ADC_BANDGAP = 16;
+const uint8_t ADC_GND     = 17;
+
+struct Timer {
+    uint64_t nextClock;   // Cycle of the next timer clock, NEVER = stopped
+    uint16_t prescale;
+};
+
+struct Uart {
+    uint64_t shiftDone;   // End of the frame in the shifter, NEVER = idle
+    bool     bufferFull;  // UDRn holds a byte behind the shifter
+    uint8_t  buffer;
+    std::deque<uint8_t> rx;
+    std::string tx;
+};
+
+struct Vector {
+    void (*isr)(void);
+    uint16_t flagReg;
+    uint8_t  flagBit;
+    uint16_t maskReg;
+    uint8_t  maskBit;
+};
+
+// In vector table order = priority order
+const Vector vectors[] = {
+    { WDT_vect,          R_WDTCSR, WDIF,  R_WDTCSR, WDIE   },
+    { TIMER1_COMPA_vect, R_TIFR1,  OCF1A, R_TIMSK1, OCIE1A },
+    { TIMER1_COMPB_vect, R_TIFR1,  OCF1B, R_TIMSK1, OCIE1B },
+    { TIMER1_OVF_vect,   R_TIFR1,  TOV1,  R_TIMSK1, TOIE1  },
+    { TIMER0_COMPA_vect, R_TIFR0,  OCF0A, R_TIMSK0, OCIE0A },
+    { TIMER0_COMPB_vect, R_TIFR0,  OCF0B, R_TIMSK0, OCIE0B },
+    { TIMER0_OVF_vect,   R_TIFR0,  TOV0,  R_TIMSK0, TOIE0  },
+    { ADC_vect,          R_ADCSRA, ADIF,  R_ADCSRA, ADIE   },
+};
+
+uint64_t now;
+uint32_t interruptCount;
+
+Timer timer0;
+Timer timer1;
+bool clkIoHalted;         // ADC noise reduction sleep
+uint64_t haltStart;
+
+uint64_t adcDone;         // NEVER = no conversion running
+bool adcFirst;            // First conversion after ADEN takes 25 ADC clocks
+uint8_t adcChannel;       // Latched at the start of the conversion
+uint16_t adcInput[ADC_GND + 1];
+uint32_t adcCount;
+
+Uart uarts[HOST_UART_COUNT];
+
+uint64_t wdtStart;        // Last wdt_reset() or enable
+uint64_t wdtDeadline;     // NEVER = stopped
+uint16_t wdtResets;
+
+uint8_t eeprom[HOST_EEPROM_SIZE];
+uint64_t eepromReady;
+
+struct EepromInit {
+    EepromInit() { memset(eeprom, 0xFF, sizeof(eeprom)); }
+} eepromInit;
+
+inline uint64_t usToCycles(double us) {
+    return (uint64_t)(us * (HOST_F_CPU / 1000000UL) + 0.5);
+}
+
+inline bool regBit(uint16_t reg, uint8_t bit) {
+    return hostRegs[reg] & (1 << bit);
+}
+
+// -----------------------------------------------------------------------------
+// ADC
+// -----------------------------------------------------------------------------
+
+uint8_t adcSelectedChannel() {
+    uint8_t mux = hostRegs[R_ADMUX] & 0x1F;
+    bool mux5 = regBit(R_ADCSRB, MUX5);
+
+    if (mux < 8) return mux + (mux5 ? 8 : 0);
+    if (!mux5 && mux == 0x1E) return ADC_BANDGAP;
+    return ADC_GND;   // Differential and gain inputs are not modelled
+}
+
+void adcStart() {
+    static const uint8_t divider[8] = { 2, 2, 4, 8, 16, 32, 64, 128 };
+    uint8_t clocks = adcFirst ? 25 : 13;
+
+    adcFirst = false;
+    adcChannel = adcSelectedChannel();
+    adcDone = now + (uint64_t)clocks * divider[hostRegs[R_ADCSRA] & 0x07];
+    hostRegs[R_ADCSRA] |= (1 << ADSC);
+}
+
+void adcTrigger(uint8_t source) {
+    if (!regBit(R_ADCSRA, ADEN) || !regBit(R_ADCSRA, ADATE)) return;
+    if ((hostRegs[R_ADCSRB] & 0x07) != source) return;
+    if (adcDone == NEVER) adcStart();   // A trigger during a conversion is lost
+}
+
+void adcComplete() {
+    uint16_t result = adcInput[adcChannel] & 0x3FF;
+    if (regBit(R_ADMUX, ADLAR)) result <<= 6;
+
+    hostRegs[R_ADCL] = result & 0xFF;
+    hostRegs[R_ADCH] = result >> 8;
+    hostRegs[R_ADCSRA] = (hostRegs[R_ADCSRA] & ~(1 << ADSC)) | (1 << ADIF);
+    adcDone = NEVER;
+    adcCount++;
+
+    adcTrigger(TRIG_FREE_RUNNING);
+}
+
+void adcWrite(uint8_t value) {
+    uint8_t old = hostRegs[R_ADCSRA];
+    uint8_t reg = (value & ~((1 << ADIF) | (1 << ADSC))) | (old & ((1 << ADIF) | (1 << ADSC)));
+
+    if (value & (1 << ADIF)) reg &= ~(1 << ADIF);   // Write one to clear
+    if (!(reg & (1 << ADEN))) {
+        reg &= ~(1 << ADSC);                        // Disabling aborts a conversion
+        adcDone = NEVER;
+    } else if (!(old & (1 << ADEN))) {
+        adcFirst = true;
+    }
+    hostRegs[R_ADCSRA] = reg;
+
+    if ((value & (1 << ADSC)) && (reg & (1 << ADEN)) && adcDone == NEVER) adcStart();
+}
+
+// -----------------------------------------------------------------------------
+// Timer0 / Timer1
+// -----------------------------------------------------------------------------
+
+void raiseFlag(uint16_t reg, uint8_t bit, uint8_t trigger) {
+    if (regBit(reg, bit)) return;
+    hostRegs[reg] |= (1 << bit);
+    adcTrigger(trigger);   // Auto trigger fires on the flag's rising edge
+}
+
+void timerConfigure(Timer& timer, uint8_t tccrb) {
+    static const uint16_t prescale[8] = { 0, 1, 8, 64, 256, 1024, 0, 0 };  // 6/7 = external pin
+    uint16_t p = prescale[tccrb & 0x07];
+
+    if (p == timer.prescale) return;
+    timer.prescale = p;
+    timer.nextClock = p ? now + p : NEVER;
+}
+
+/**
+ * One timer clock. The compare flag is set and, in CTC mode, the counter
+ * cleared at the clock after TCNTn matched OCRnA.
+ */
+void timer0Clock() {
+    uint8_t tcnt = hostRegs[R_TCNT0];
+    uint8_t wgm = (hostRegs[R_TCCR0A] & 0x03) | (regBit(R_TCCR0B, WGM02) ? 0x04 : 0);
+
+    if (tcnt == hostRegs[R_OCR0B]) raiseFlag(R_TIFR0, OCF0B, 0xFF);
+    if (tcnt == hostRegs[R_OCR0A]) raiseFlag(R_TIFR0, OCF0A, TRIG_TIMER0_COMPA);
+
+    if (wgm == 2 && tcnt == hostRegs[R_OCR0A]) {
+        tcnt = 0;
+    } else if (++tcnt == 0) {
+        raiseFlag(R_TIFR0, TOV0, TRIG_TIMER0_OVF);
+    }
+    hostRegs[R_TCNT0] = tcnt;
+}
+
+inline uint16_t reg16(uint16_t addr) {
+    return hostRegs[addr] | ((uint16_t)hostRegs[addr + 1] << 8);
+}
+
+void timer1Clock() {
+    uint16_t tcnt = reg16(R_TCNT1);
+    uint8_t wgm = (hostRegs[R_TCCR1A] & 0x03) | ((hostRegs[R_TCCR1B] >> WGM12) & 0x03) << 2;
+    uint16_t top = (wgm == 4) ? reg16(R_OCR1A) : (wgm == 12) ? reg16(R_ICR1) : 0xFFFF;
+
+    if (tcnt == reg16(R_OCR1B)) raiseFlag(R_TIFR1, OCF1B, TRIG_TIMER1_COMPB);
+    if (tcnt == reg16(R_OCR1A)) raiseFlag(R_TIFR1, OCF1A, 0xFF);
+
+    if (tcnt == top) {
+        tcnt = 0;
+        if (top == 0xFFFF) raiseFlag(R_TIFR1, TOV1, TRIG_TIMER1_OVF);
+    } else {
+        tcnt++;
+    }
+    hostRegs[R_TCNT1] = tcnt & 0xFF;
+    hostRegs[R_TCNT1 + 1] = tcnt >> 8;
+}
+
+// -----------------------------------------------------------------------------
+// USART
+// -----------------------------------------------------------------------------
+
+int uartIndex(uint16_t addr) {
+    for (uint8_t n = 0; n < HOST_UART_COUNT; n++) {
+        if (addr >= uartBase[n] && addr <= uartBase[n] + U_UDR) return n;
+    }
+    return -1;
+}
+
+uint64_t uartFrameCycles(uint8_t n) {
+    uint16_t base = uartBase[n];
+    uint16_t ubrr = hostRegs[base + U_UBRRL] | ((hostRegs[base + U_UBRRH] & 0x0F) << 8);
+    uint8_t ucsrc = hostRegs[base + U_UCSRC];
+    uint8_t bits = 1 + 5 + ((ucsrc >> 1) & 0x03)   // Start + data
+                 + ((ucsrc & 0x30) ? 1 : 0)        // Parity
+                 + ((ucsrc & 0x08) ? 2 : 1);       // Stop
+    uint8_t divider = regBit(base + U_UCSRA, U2X0) ? 8 : 16;
+
+    return (uint64_t)bits * divider * (ubrr + 1);
+}
+
+void uartShift(uint8_t n, uint8_t data) {
+    uarts[n].tx += (char)data;
+    uarts[n].shiftDone = now + uartFrameCycles(n);
+}
+
+void uartShiftDone(uint8_t n) {
+    Uart& u = uarts[n];
+    uint16_t ucsra = uartBase[n] + U_UCSRA;
+
+    if (u.bufferFull) {
+        u.bufferFull = false;
+        uartShift(n, u.buffer);
+        hostRegs[ucsra] |= (1 << UDRE0);
+    } else {
+        u.shiftDone = NEVER;
+        hostRegs[ucsra] |= (1 << TXC0);
+    }
+}
+
+void uartWrite(uint8_t n, uint8_t offset, uint8_t value) {
+    Uart& u = uarts[n];
+    uint16_t base = uartBase[n];
+
+    switch (offset) {
+    case U_UCSRA: {
+        uint8_t keep = (1 << U2X0) | (1 << MPCM0);
+        uint8_t reg = (hostRegs[base] & ~keep) | (value & keep);
+        if (value & (1 << TXC0)) reg &= ~(1 << TXC0);   // Write one to clear
+        hostRegs[base] = reg;
+        break;
+    }
+    case U_UDR:
+        if (!regBit(base + U_UCSRB, TXEN0)) break;      // Transmitter off: ignored
+        if (u.shiftDone == NEVER) {
+            uartShift(n, value);
+        } else if (!u.bufferFull) {
+            u.bufferFull = true;
+            u.buffer = value;
+            hostRegs[base] &= ~(1 << UDRE0);
+        }                                               // UDREn clear: ignored
+        break;
+    default:
+        hostRegs[base + offset] = value;
+        break;
+    }
+}
+
+uint8_t uartRead(uint8_t n, uint8_t offset) {
+    Uart& u = uarts[n];
+    uint16_t base = uartBase[n];
+
+    if (offset == U_UDR && !u.rx.empty()) {
+        hostRegs[base + U_UDR] = u.rx.front();
+        u.rx.pop_front();
+        if (u.rx.empty()) hostRegs[base] &= ~(1 << RXC0);
+    }
+    return hostRegs[base + offset];
+}
+
+// -----------------------------------------------------------------------------
+// Watchdog
+// -----------------------------------------------------------------------------
+
+uint64_t wdtPeriod() {
+    uint8_t reg = hostRegs[R_WDTCSR];
+    uint8_t p = (reg & 0x07) | ((reg & (1 << WDP3)) ? 0x08 : 0);
+    if (p > 9) p = 9;
+    return usToCycles(16000.0) << p;   // 2K cycles of the 128 kHz oscillator
+}
+
+void wdtWrite(uint8_t value) {
+    uint8_t reg = (value & ~(1 << WDIF)) | (hostRegs[R_WDTCSR] & (1 << WDIF));
+    if (value & (1 << WDIF)) reg &= ~(1 << WDIF);
+    hostRegs[R_WDTCSR] = reg;
+
+    if (reg & ((1 << WDE) | (1 << WDIE))) {
+        if (wdtDeadline == NEVER) wdtStart = now;
+        wdtDeadline = wdtStart + wdtPeriod();
+    } else {
+        wdtDeadline = NEVER;
+    }
+}
+
+void wdtTimeout() {
+    uint8_t reg = hostRegs[R_WDTCSR];
+
+    wdtStart = now;
+    if (reg & (1 << WDIE)) {
+        hostRegs[R_WDTCSR] |= (1 << WDIF);   // Interrupt stage first
+        wdtDeadline = now + wdtPeriod();
+    } else {
+        wdtResets++;                         // The firmware would restart here
+        hostRegs[R_MCUSR] |= (1 << WDRF);
+        wdtDeadline = NEVER;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Event Loop
+// -----------------------------------------------------------------------------
+
+uint64_t nextEvent() {
+    uint64_t next = NEVER;
+
+    if (!clkIoHalted) {
+        if (timer0.nextClock < next) next = timer0.nextClock;
+        if (timer1.nextClock < next) next = timer1.nextClock;
+        for (uint8_t n = 0; n < HOST_UART_COUNT; n++) {
+            if (uarts[n].shiftDone < next) next = uarts[n].shiftDone;
+        }
+    }
+    if (adcDone < next) next = adcDone;
+    if (wdtDeadline < next) next = wdtDeadline;
+    return next;
+}
+
+/**
+ * Moves to the next event or target, whichever comes first, and handles
+ * everything due by then.
+ */
+void step(uint64_t target) {
+    uint64_t next = nextEvent();
+    if (next > target) next = target;
+    if (next > now) now = next;   // Nested calls from an ISR may be ahead
+
+    if (!clkIoHalted) {
+        if (timer0.nextClock <= now) {
+            timer0.nextClock += timer0.prescale;
+            timer0Clock();
+        }
+        if (timer1.nextClock <= now) {
+            timer1.nextClock += timer1.prescale;
+            timer1Clock();
+        }
+        for (uint8_t n = 0; n < HOST_UART_COUNT; n++) {
+            if (uarts[n].shiftDone <= now) uartShiftDone(n);
+        }
+    }
+    if (adcDone <= now) adcComplete();
+    if (wdtDeadline <= now) wdtTimeout();
+}
+
+bool interruptPending() {
+    for (const Vector& v : vectors) {
+        if (regBit(v.flagReg, v.flagBit) && regBit(v.maskReg, v.maskBit)) return true;
+    }
+    return false;
+}
+
+/**
+ * Takes pending interrupts while SREG.I is set: the flag is cleared and
+ * the ISR runs with I cleared, then RETI sets it again.
+ */
+void dispatch() {
+    while (regBit(R_SREG, SREG_I)) {
+        const Vector* taken = 0;
+        for (const Vector& v : vectors) {
+            if (v.isr && regBit(v.flagReg, v.flagBit) && regBit(v.maskReg, v.maskBit)) {
+                taken = &v;
+                break;
+            }
+        }
+        if (!taken) return;
+
+        hostRegs[taken->flagReg] &= ~(1 << taken->flagBit);
+        if (taken->isr == WDT_vect && regBit(R_WDTCSR, WDE)) {
+            hostRegs[R_WDTCSR] &= ~(1 << WDIE);   // Next timeout resets
+        }
+
+        hostRegs[R_SREG] &= ~(1 << SREG_I);
+        interruptCount++;
+        taken->isr();
+        hostRegs[R_SREG] |= (1 << SREG_I);
+    }
+}
+
+void advanceTo(uint64_t target) {
+    do {
+        step(target);
+        dispatch();
+    } while (now < target);
+}
+
+void advance(uint64_t cycles) {
+    advanceTo(now + cycles);
+}
+
+void haltClkIo(bool halt) {
+    if (halt == clkIoHalted) return;
+    clkIoHalted = halt;
+
+    if (halt) {
+        haltStart = now;
+        return;
+    }
+
+    // Everything on clkIO resumes where it stopped
+    uint64_t halted = now - haltStart;
+    if (timer0.nextClock != NEVER) timer0.nextClock += halted;
+    if (timer1.nextClock != NEVER) timer1.nextClock += halted;
+    for (uint8_t n = 0; n < HOST_UART_COUNT; n++) {
+        if (uarts[n].shiftDone != NEVER) uarts[n].shiftDone += halted;
+    }
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+// Register Access
+// -----------------------------------------------------------------------------
+
+uint8_t hostRead8(uint16_t addr) {
+    advance(HOST_REG_CYCLES);
+
+    int n = uartIndex(addr);
+    if (n >= 0) return uartRead(n, addr - uartBase[n]);
+    return hostRegs[addr];
+}
+
+void hostWrite8(uint16_t addr, uint8_t value) {
+    int n = uartIndex(addr);
+
+    if (n >= 0) {
+        uartWrite(n, addr - uartBase[n], value);
+    } else {
+        switch (addr) {
+        case R_TIFR0:
+        case R_TIFR1:
+            hostRegs[addr] &= ~value;   // Write one to clear
+            break;
+        case R_MCUSR:
+            hostRegs[addr] &= value;    // Flags are cleared by writing zero
+            break;
+        case R_TCCR0B:
+            hostRegs[addr] = value;
+            timerConfigure(timer0, value);
+            break;
+        case R_TCCR1B:
+            hostRegs[addr] = value;
+            timerConfigure(timer1, value);
+            break;
+        case R_ADCSRA:
+            adcWrite(value);
+            break;
+        case R_WDTCSR:
+            wdtWrite(value);
+            break;
+        default:
+            hostRegs[addr] = value;
+            break;
+        }
+    }
+
+    advance(HOST_REG_CYCLES);
+}
+
+// -----------------------------------------------------------------------------
+// Simulation Control
+// -----------------------------------------------------------------------------
+
+void hostReset() {
+    memset((void*)hostRegs, 0, sizeof(hostRegs));
+    hostRegs[R_MCUSR] = (1 << PORF);
+
+    now = 0;
+    interruptCount = 0;
+    timer0 = { NEVER, 0 };
+    timer1 = { NEVER, 0 };
+    clkIoHalted = false;
+
+    adcDone = NEVER;
+    adcFirst = false;
+    adcChannel = 0;
+    memset(adcInput, 0, sizeof(adcInput));
+    adcInput[ADC_BANDGAP] = 225;   // 1.1 V against AVcc = 5 V
+    adcCount = 0;
+
+    for (uint8_t n = 0; n < HOST_UART_COUNT; n++) {
+        uarts[n].shiftDone = NEVER;
+        uarts[n].bufferFull = false;
+        uarts[n].rx.clear();
+        uarts[n].tx.clear();
+        hostRegs[uartBase[n] + U_UCSRA] = (1 << UDRE0);
+        hostRegs[uartBase[n] + U_UCSRC] = (1 << UCSZ01) | (1 << UCSZ00);
+    }
+
+    wdtStart = 0;
+    wdtDeadline = NEVER;
+    wdtResets = 0;
+    eepromReady = 0;
+}
+
+void hostAdvanceCycles(uint32_t cycles) {
+    advance(cycles);
+}
+
+void hostAdvanceUs(uint32_t us) {
+    advance(usToCycles(us));
+}
+
+uint64_t hostCycles() {
+    return now;
+}
+
+uint32_t hostInterrupts() {
+    return interruptCount;
+}
+
+void hostAdcSetInput(uint8_t channel, uint16_t counts) {
+    if (channel <= ADC_GND) adcInput[channel] = counts;
+}
+
+uint32_t hostAdcConversions() {
+    return adcCount;
+}
+
+void hostUartInject(uint8_t port, const char* data) {
+    if (port >= HOST_UART_COUNT) return;
+    while (*data) uarts[port].rx.push_back((uint8_t)*data++);
+    if (!uarts[port].rx.empty()) hostRegs[uartBase[port] + U_UCSRA] |= (1 << RXC0);
+}
+
+std::string hostUartOutput(uint8_t port) {
+    std::string out;
+    if (port < HOST_UART_COUNT) out.swap(uarts[port].tx);
+    return out;
+}
+
+uint8_t* hostEeprom() {
+    return eeprom;
+}
+
+uint16_t hostWatchdogResets() {
+    return wdtResets;
+}
+
+// -----------------------------------------------------------------------------
+// avr-libc Replacements
+// -----------------------------------------------------------------------------
+
+void cli(void) {
+    hostRegs[R_SREG] &= ~(1 << SREG_I);
+}
+
+void sei(void) {
+    hostRegs[R_SREG] |= (1 << SREG_I);   // Pending interrupts run at the next access
+}
+
+void sleep_cpu(void) {
+    if (!regBit(R_SMCR, SE)) return;
+
+    uint8_t mode = hostRegs[R_SMCR] & ((1 << SM2) | (1 << SM1) | (1 << SM0));
+    if (mode == SLEEP_MODE_ADC) {
+        if (regBit(R_ADCSRA, ADEN) && adcDone == NEVER) adcStart();
+        haltClkIo(true);
+    }
+
+    // An interrupt that is already pending wakes the core at once. With
+    // nothing enabled the chip would sleep for good; give up after 1 s.
+    uint64_t limit = now + HOST_F_CPU;
+    while (!interruptPending() && now < limit) {
+        if (nextEvent() == NEVER) break;
+        step(limit);
+    }
+
+    haltClkIo(false);
+    dispatch();
+}
+
+void wdt_reset(void) {
+    wdtStart = now;
+    if (wdtDeadline != NEVER) wdtDeadline = now + wdtPeriod();
+}
+
+void _delay_us(double us) {
+    advance(usToCycles(us));
+}
+
+void _delay_ms(double ms) {
+    advance(usToCycles(ms * 1000.0));
+}
+
+bool eeprom_is_ready(void) {
+    advance(HOST_REG_CYCLES);   // Reads EECR
+    return now >= eepromReady;
+}
+
+void eeprom_busy_wait(void) {
+    if (now < eepromReady) advanceTo(eepromReady);
+}
+
+uint8_t eeprom_read_byte(const uint8_t* addr) {
+    eeprom_busy_wait();
+    advance(4);   // The CPU is halted for 4 cycles
+    return eeprom[(uintptr_t)addr & (HOST_EEPROM_SIZE - 1)];
+}
+
+void eeprom_write_byte(uint8_t* addr, uint8_t value) {
+    eeprom_busy_wait();
+    eeprom[(uintptr_t)addr & (HOST_EEPROM_SIZE - 1)] = value;
+    eepromReady = now + usToCycles(HOST_EEPROM_WRITE_US);
+    advance(2);
+}
+
+void eeprom_update_byte(uint8_t* addr, uint8_t value) {
+    if (eeprom_read_byte(addr) != value) eeprom_write_byte(addr, value);
+}
+
+void eeprom_read_block(void* dst, const void* src, size_t n) {
+    uint8_t* d = (uint8_t*)dst;
+    const uint8_t* s = (const uint8_t*)src;
+    while (n--) *d++ = eeprom_read_byte(s++);
+}
+
+void eeprom_update_block(const void* src, void* dst, size_t n) {
+    const uint8_t* s = (const uint8_t*)src;
+    uint8_t* d = (uint8_t*)dst;
+    while (n--) eeprom_update_byte(d++, *s++);
+}
+
+static char* formatNumber(unsigned long value, bool negative, char* buf, int radix) {
+    char digits[8 * sizeof(value)];
+    uint8_t n = 0;
+    char* out = buf;
+
+    if (radix < 2 || radix > 36) radix = 10;
+    do {
+        uint8_t d = value % radix;
+        digits[n++] = d < 10 ? '0' + d : 'a' + d - 10;
+        value /= radix;
+    } while (value);
+
+    if (negative) *out++ = '-';
+    while (n) *out++ = digits[--n];
+    *out = '\0';
+    return buf;
+}
+
+extern "C" char* itoa(int value, char* buf, int radix) {
+    if (radix == 10 && value < 0) return formatNumber(-(unsigned long)(long)value, true, buf, radix);
+    return formatNumber((unsigned int)value, false, buf, radix);
+}
+
+extern "C" char* utoa(unsigned int value, char* buf, int radix) {
+    return formatNumber(value, false, buf, radix);
+}
+
+extern "C" char* ltoa(long value, char* buf, int radix) {
+    if (radix == 10 && value < 0) return formatNumber(-(unsigned long)value, true, buf, radix);
+    return formatNumber((unsigned long)value, false, buf, radix);
+}
+
+extern "C" char* ultoa(unsigned long value, char* buf, int radix) {
+    return formatNumber(value, false, buf, radix);
+}
@@ -0,0 +1,103 @@
+/*
+ * Host Simulation (x86 Build)
+ * ---------------------------
+ *
+ * The host build compiles the unchanged firmware sources against the
+ * headers in Host/ instead of avr-libc. Named registers (UDR3, ADCSRA,
+ * TCNT0, ...) become HostReg8/HostReg16 proxies on a 512-byte register
+ * file with the ATmega2560 data-space layout; GPIO code that reaches the
+ * ports through computed addresses (_SFR_MEM8) uses the same file
+ * directly.
+ *
+ * Simulated time is a 16 MHz cycle counter. It only moves when the
+ * firmware waits or touches the hardware:
+ *
+ *   - every named register access costs HOST_REG_CYCLES (LDS/STS), so
+ *     busy-waits on ADSC, UDREn or TCNT0 make progress
+ *   - _delay_us()/_delay_ms() and EEPROM waits advance by their duration
+ *   - sleep_cpu() skips ahead to the next interrupt
+ *   - tests call hostAdvanceUs()/hostAdvanceCycles()
+ *
+ * Plain RAM accesses and computation take no simulated time.
+ *
+ * Modelled peripherals:
+ *   - Timer0/Timer1: normal and CTC mode, compare A/B and overflow flags
+ *   - ADC: single, free-running and Timer0/Timer1 auto trigger, ADLAR,
+ *     13/25 ADC clock conversions, noise reduction sleep (clkIO halted)
+ *   - USART0-3: polled TX at the UBRR baud rate (UDRE/TXC), RX from
+ *     hostUartInject()
+ *   - EEPROM: 4 KB, 3.4 ms per byte write, kept across hostReset()
+ *   - Watchdog: interrupt and reset mode; a reset is counted, not executed
+ *
+ * Interrupts are taken between register accesses while SREG.I is set,
+ * in vector order, with I cleared and the flag reset as on hardware.
+ * sei() takes effect at the next register access, like the one
+ * instruction delay of SEI. Vectors without an ISR in the firmware
+ * are left pending. USART interrupts are not modelled (the driver polls).
+ *
+ * Usage Example:
+ * --------------
+ *     hostReset();
+ *     Serial3.begin(115200);
+ *     Serial3.print("hi");
+ *     hostAdvanceUs(500);
+ *     assert(hostUartOutput(3) == "hi");
+ */
+
+#ifndef HOST_SIM_H_
+#define HOST_SIM_H_
+
+#include <stdint.h>
+#include <string>
+
+#define HOST_F_CPU          16000000UL
+#define HOST_REG_SPACE      0x200   // 0x20-0x1FF: I/O and extended I/O
+#define HOST_REG_CYCLES     2       // One LDS/STS per named register access
+#define HOST_UART_COUNT     4
+#define HOST_ADC_CHANNELS   16
+#define HOST_EEPROM_SIZE    4096
+#define HOST_EEPROM_WRITE_US 3400   // Erase + write, datasheet typical
+
+extern volatile uint8_t hostRegs[HOST_REG_SPACE];
+
+// Register hooks, used by the HostReg8/HostReg16 proxies in <avr/io.h>
+uint8_t hostRead8(uint16_t addr);
+void    hostWrite8(uint16_t addr, uint8_t value);
+
+/**
+ * @brief Power-on reset: clears registers, peripherals and the cycle
+ * counter. EEPROM contents survive; firmware globals are not touched.
+ */
+void hostReset();
+
+/**
+ * @brief Lets simulated time pass, taking interrupts as they fall due.
+ */
+void hostAdvanceCycles(uint32_t cycles);
+void hostAdvanceUs(uint32_t us);
+
+uint64_t hostCycles();              // Cycles since hostReset()
+uint32_t hostInterrupts();          // ISRs taken since hostReset()
+
+/**
+ * @brief Sets the conversion result for an ADC input.
+ * @param channel ADC0-ADC15; 16 = 1.1 V bandgap, 17 = GND
+ * @param counts  10-bit result (ADLAR shifts it like the hardware)
+ */
+void hostAdcSetInput(uint8_t channel, uint16_t counts);
+uint32_t hostAdcConversions();      // Completed conversions since hostReset()
+
+/**
+ * @brief Queues bytes on USARTn's receiver (RXCn set until all are read).
+ */
+void hostUartInject(uint8_t port, const char* data);
+
+/**
+ * @brief Returns everything USARTn has shifted out so far and clears it.
+ */
+std::string hostUartOutput(uint8_t port);
+
+uint8_t* hostEeprom();              // HOST_EEPROM_SIZE bytes, 0xFF = erased
+uint16_t hostWatchdogResets();      // Watchdog timeouts in reset mode
+
+#endif /* HOST_SIM_H_ */
@@ -0,0 +1,24 @@
+/*
+ * <stdlib.h> for the host build: the C library's header plus the
+ * avr-libc number conversions the drivers use.
+ */
+
+#ifndef HOST_STDLIB_H_
+#define HOST_STDLIB_H_
+
+#include_next <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+char* itoa(int value, char* buf, int radix);
+char* utoa(unsigned int value, char* buf, int radix);
+char* ltoa(long value, char* buf, int radix);
+char* ultoa(unsigned long value, char* buf, int radix);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_STDLIB_H_ */
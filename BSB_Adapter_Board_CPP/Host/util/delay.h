@@ -0,0 +1,13 @@
+/*
+ * Busy-wait delays for the host build: simulated time advances by the
+ * requested duration and interrupts are taken on the way, as they would
+ * be on the hardware.
+ */
+
+#ifndef HOST_UTIL_DELAY_H_
+#define HOST_UTIL_DELAY_H_
+
+void _delay_us(double us);
+void _delay_ms(double ms);
+
+#endif /* HOST_UTIL_DELAY_H_ */
@@ -3,19 +3,41 @@
 #include <avr/interrupt.h>
 #include "board.h"
 #include "tasks.h"
-#include "Serial.h"
+#include "serial.h"
+#include "watchdog.h"
+#include "config.h"
+#include "trace.h"
+#include "postmortem.h"
+#include "metrics.h"
 
 #include <string.h> // Optional for memset()
 
 Scheduler scheduler;
 
+// Timer0 counts per 1 ms tick and microseconds per count (prescaler 64)
+#define TIMER0_TOP           ((F_CPU / 64 / 1000) - 1)
+#define TIMER0_US_PER_COUNT  (64000000UL / F_CPU)
+
 void blinkTask(void);
 void uart3Task(void);
 
+extern volatile uint32_t schedulerTickCount;
+
+/**
+ * @brief Reads the 32-bit tick counter without tearing against the ISR.
+ */
+static uint32_t ticksNow() {
+	uint8_t sreg = SREG;
+	cli();
+	uint32_t now = schedulerTickCount;
+	SREG = sreg;
+	return now;
+}
+
 void Scheduler::init() {
 	TCCR0A = (1 << WGM01);
 	TCCR0B = (1 << CS01) | (1 << CS00);
-	OCR0A = (F_CPU / 64 / 1000) - 1;
+	OCR0A = TIMER0_TOP;
 	TIMSK0 |= (1 << OCIE0A);
 }
 
@@ -23,7 +45,8 @@ void Scheduler::start() {
 	sei();
 }
 
-void Scheduler::addTask(void (*taskFunc)(), uint8_t priority, uint16_t period_ms) {
+void Scheduler::addTask(void (*taskFunc)(), uint8_t priority, uint16_t period_ms,
+                        uint16_t maxRuntime_ms, bool critical, uint8_t requires) {
 	if (!taskFunc || priority >= MAX_PRIORITY)
 	return;
 
@@ -41,7 +64,12 @@ void Scheduler::addTask(void (*taskFunc)(), uint8_t priority, uint16_t period_ms
 				.ready = false,
 				.active = true,
 				.missedDeadline = false,
-				.oneShot = false
+				.oneShot = false,
+				.critical = critical,
+				.maxRuntime = maxRuntime_ms,
+				.overruns = 0,
+				.lastRun = ticksNow(),
+				.requires = requires
 			};
 			return;
 		}
@@ -71,7 +99,12 @@ void Scheduler::setTimeout(void (*taskFunc)(), uint16_t delay_ms) {
 				.ready = false,
 				.active = true,
 				.missedDeadline = false,
-				.oneShot = true
+				.oneShot = true,
+				.critical = false,
+				.maxRuntime = 0,
+				.overruns = 0,
+				.lastRun = ticksNow(),
+				.requires = 0
 			};
 			taskCount++;
 			return;
@@ -79,6 +112,19 @@ void Scheduler::setTimeout(void (*taskFunc)(), uint16_t delay_ms) {
 	}
 }
 
+void Scheduler::notify(void (*taskFunc)()) {
+	for (uint8_t i = 0; i < MAX_TASKS; ++i) {
+		if (tasks[i].active && tasks[i].func == taskFunc) {
+			tasks[i].ready = true;
+			return;
+		}
+	}
+}
+
+void Scheduler::setIdleHook(void (*hook)()) {
+	idleHook = hook;
+}
+
 volatile uint32_t schedulerTickCount = 0;  // Add this at global level
 
 
@@ -86,8 +132,21 @@ void Scheduler::tick() {
 	
 	    schedulerTickCount++;  // <-- Add this line to maintain global tick count
 
+	// Runtime budget of the task currently executing in run()
+	if (runningSlot != SCHED_NO_TASK) {
+		Task& t = tasks[runningSlot];
+		if (t.maxRuntime && ++runningTicks > t.maxRuntime) {
+			if (runningTicks == t.maxRuntime + 1) {  // Count once per call
+				t.overruns++;
+				METRIC_INC(SCHED_OVERRUNS);
+				postmortem.log(PM_TASK_OVERRUN, runningSlot, t.maxRuntime);
+			}
+			if (t.critical) watchdog.forceReset(WDT_CAUSE_OVERRUN, runningSlot);
+		}
+	}
+
 	for (uint8_t i = 0; i < MAX_TASKS; ++i) {
-		if (tasks[i].active) {
+		if (tasks[i].active && tasks[i].period != SCHED_EVENT) {
 			tasks[i].counter++;
 			if (tasks[i].counter >= tasks[i].period) {
 				// Missed deadline?
@@ -102,12 +161,32 @@ void Scheduler::tick() {
 }
 
 void Scheduler::run() {
+	bool ranTask = false;
+
 	for (uint8_t p = 0; p < MAX_PRIORITY; ++p) {
 		for (uint8_t i = 0; i < MAX_TASKS; ++i) {
 			if (tasks[i].active && tasks[i].ready && tasks[i].priority == p) {
+				// Peripheral not up yet: skip, events stay pending
+				if (!isReady(tasks[i].requires)) {
+					if (tasks[i].period != SCHED_EVENT) tasks[i].ready = false;
+					tasks[i].lastRun = ticksNow();
+					continue;
+				}
+
 				tasks[i].ready = false;
 				tasks[i].missedDeadline = false;
+
+				runningTicks = 0;
+				runningSlot = i;
+				watchdog.enterTask(i);
+				TRACE_TASK_BEGIN_EVT(i);
+				METRIC_INC(SCHED_DISPATCHES);
 				tasks[i].func();
+				TRACE_TASK_END_EVT(i);
+				watchdog.leaveTask();
+				ranTask = true;
+				runningSlot = SCHED_NO_TASK;
+				tasks[i].lastRun = ticksNow();  // Heartbeat
 
 				if (tasks[i].oneShot) {
 					tasks[i].active = false;
@@ -115,6 +194,37 @@ void Scheduler::run() {
 			}
 		}
 	}
+
+	if (!ranTask && idleHook) {
+		idleHook();
+	}
+
+	// Only a fully healthy system keeps the hardware watchdog quiet
+	if (tasksHealthy()) {
+		watchdog.feed();
+	}
+}
+
+/**
+ * @brief Checks the heartbeat of every critical task.
+ *
+ * A critical task is starved when it has not completed within its period
+ * plus its runtime budget and HEARTBEAT_SLACK_MS. Starvation is recorded for
+ * the post-reset report and the watchdog is left to expire.
+ */
+bool Scheduler::tasksHealthy() {
+	uint32_t now = ticksNow();
+
+	for (uint8_t i = 0; i < MAX_TASKS; ++i) {
+		if (tasks[i].active && tasks[i].critical) {
+			uint32_t limit = (uint32_t)tasks[i].period + tasks[i].maxRuntime + HEARTBEAT_SLACK_MS;
+			if (now - tasks[i].lastRun > limit) {
+				watchdog.flag(WDT_CAUSE_STARVED, i);
+				return false;
+			}
+		}
+	}
+	return true;
 }
 
 void Scheduler::debugTaskMonitor() {
@@ -127,18 +237,42 @@ void Scheduler::debugTaskMonitor() {
 			Serial3.print(" | Cnt="); Serial3.print(tasks[i].counter);
 			Serial3.print(" | Ready="); Serial3.print(tasks[i].ready);
 			Serial3.print(" | Missed="); Serial3.print(tasks[i].missedDeadline);
-			Serial3.print(" | OneShot="); Serial3.println(tasks[i].oneShot);
+			Serial3.print(" | OneShot="); Serial3.print(tasks[i].oneShot);
+			Serial3.print(" | Crit="); Serial3.print(tasks[i].critical);
+			Serial3.print(" | MaxRt="); Serial3.print(tasks[i].maxRuntime);
+			Serial3.print(" | Overruns="); Serial3.print(tasks[i].overruns);
+			Serial3.print(" | Req="); Serial3.println(tasks[i].requires);
 		}
 	}
 	Serial3.println("================================");
 }
 
 ISR(TIMER0_COMPA_vect) {
+	TRACE_ISR_ENTER_EVT(TRACE_ISR_TIMER0);
 	scheduler.tick();
+	TRACE_ISR_EXIT_EVT(TRACE_ISR_TIMER0);
 }
 
 
-extern volatile uint32_t schedulerTickCount;
+uint32_t schedulerTicks(void) {
+	return ticksNow();
+}
+
+uint32_t micros(void) {
+	uint8_t sreg = SREG;
+	cli();
+	uint32_t ticks = schedulerTickCount;
+	uint8_t count = TCNT0;
+
+	// Counter already wrapped to 0 but TIMER0_COMPA_vect is still pending.
+	// At TOP the flag may already be set without the wrap, hence the guard.
+	if ((TIFR0 & (1 << OCF0A)) && count < TIMER0_TOP) {
+		ticks++;
+	}
+	SREG = sreg;
+
+	return ticks * 1000UL + (uint32_t)count * TIMER0_US_PER_COUNT;
+}
 
 bool vTaskDelay(uint16_t delayTicks) {
 	static uint32_t lastTick = 0;
@@ -159,10 +293,21 @@ bool vTaskDelayUntil(uint32_t* lastWakeTick, uint16_t periodTicks) {
 }
 
 void Scheduler::begin() {
+	const BoardConfig& cfg = config.get();  // Loaded by Board_Init()
+
 	init();
-	addTask(blinkTask, 2, 150); 
-	addTask(uart3Task, 1, 1000);
-	addTask(lcdTask,3, 1000);
-	addTask(ADCTask,1,1000);
+	watchdog.begin(WDTO_1S);  // Must outlast the longest task budget below
+	addTask(blinkTask, 2, cfg.blinkPeriod, 5, true); 
+	addTask(uart3Task, 1, cfg.uartPeriod, 50, true, BOARD_READY_SERIAL);
+	addTask(lcdTask,3, cfg.lcdPeriod, 20, false, BOARD_READY_LCD);
+	addTask(lcdServiceTask, 3, 1, 5);           // One LCD byte per ms (queued mode)
+	// Changes only; a full refresh blocks for ~150 chars at 9600 baud, so the
+	// first one waits until the LCD power-up in lcdServiceTask is through
+	addTask(ADCTask,1,cfg.adcPeriod, 400, true, BOARD_READY_SERIAL | BOARD_READY_ADC | BOARD_READY_LCD);
+	addTask(adcAlarmTask, 0, SCHED_EVENT, 50, false, BOARD_READY_SERIAL);  // Woken by adcWindows
+	addTask(adcStatsTask, 4, cfg.statsPeriod, 100, false, BOARD_READY_SERIAL | BOARD_READY_ADC);  // One channel summary per run
+	addTask(configTask, MAX_PRIORITY - 1, 4, 5);  // EEPROM write-behind, one byte per ~3.3 ms
+	addTask(consoleTask, 5, 100, 100, false, BOARD_READY_SERIAL);  // 'T' trace, 'M' metrics
+	addTask(logTask, 8, 1, 2);   // ~1 byte per ms at 9600 baud; idle until initSerial() sets the sink
 	start();
 }
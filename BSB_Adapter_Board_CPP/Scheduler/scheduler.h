@@ -3,9 +3,13 @@
 
 #include <stdint.h>
 
-#define MAX_TASKS     8
+#define MAX_TASKS     12
 #define MAX_PRIORITY  10
 
+#define SCHED_NO_TASK        0xFF
+#define SCHED_EVENT          0xFFFF  // Period of a task that only runs on notify()
+#define HEARTBEAT_SLACK_MS   500   // Grace period before a critical task counts as starved
+
 class Scheduler {
 	public:
 	void init();
@@ -14,10 +18,42 @@ class Scheduler {
 	void tick();
 	void run();
 
-	void addTask(void (*taskFunc)(), uint8_t priority, uint16_t period_ms);
+	/**
+	 * @brief Registers a periodic task.
+	 *
+	 * @param maxRuntime_ms Longest time one call may take (0 = unchecked)
+	 * @param critical      Watchdog is only fed while this task is healthy;
+	 *                      exceeding maxRuntime_ms forces a reset
+	 * @param requires      Readiness flags (see setReady()) that must all be
+	 *                      set before the task runs; 0 = none
+	 */
+	void addTask(void (*taskFunc)(), uint8_t priority, uint16_t period_ms,
+	             uint16_t maxRuntime_ms = 0, bool critical = false,
+	             uint8_t requires = 0);
 	void removeTask(void (*taskFunc)());
 	void setTimeout(void (*taskFunc)(), uint16_t delay_ms); // One-shot
 
+	/**
+	 * @brief Marks a task ready to run on the next pass of run().
+	 * Safe to call from ISRs. Tasks added with period SCHED_EVENT run
+	 * only this way.
+	 */
+	void notify(void (*taskFunc)());
+
+	/**
+	 * @brief Function run() calls when no task was ready (nullptr = none).
+	 * Must return quickly; it delays the next dispatch.
+	 */
+	void setIdleHook(void (*hook)());
+
+	/**
+	 * @brief Marks peripherals as initialised (bit meanings are up to the
+	 * board, see board.h). Tasks whose requirements are not met are skipped
+	 * and count as alive for the watchdog.
+	 */
+	void setReady(uint8_t flags) { readyFlags |= flags; }
+	bool isReady(uint8_t flags) const { return (readyFlags & flags) == flags; }
+
 	void debugTaskMonitor();  // Print task states
 
 	private:
@@ -30,12 +66,23 @@ class Scheduler {
 		bool active;          // If this slot is in use
 		bool missedDeadline;  // True if task was skipped
 		bool oneShot;         // True if setTimeout() task
+		bool critical;        // Supervised by the hardware watchdog
+		uint16_t maxRuntime;  // Runtime budget in ms (0 = unchecked)
+		uint8_t overruns;     // Calls that exceeded maxRuntime
+		uint32_t lastRun;     // Heartbeat: tick of the last completed call
+		uint8_t requires;     // Readiness flags needed before the first run
 	};
 
 	Task tasks[MAX_TASKS];
 	uint8_t taskCount = 0;
 
+	volatile uint8_t runningSlot = SCHED_NO_TASK;  // Task inside run()
+	volatile uint16_t runningTicks = 0;            // Its runtime so far (ms)
+	void (*idleHook)() = nullptr;
+	uint8_t readyFlags = 0;
+
 	void markMissedDeadlines();
+	bool tasksHealthy();
 };
 
 
@@ -56,6 +103,56 @@ bool vTaskDelay(uint16_t delayTicks);
  */
 bool vTaskDelayUntil(uint32_t* lastWakeTick, uint16_t periodTicks);
 
+/**
+ * @brief Scheduler ticks (ms) since start, read without tearing.
+ */
+uint32_t schedulerTicks(void);
+
+/**
+ * @brief Microseconds since the scheduler timer was started.
+ *
+ * Combines the 1 ms tick with TCNT0 (4 us per count at prescaler 64) and a
+ * compare match whose ISR has not run yet. Safe to call with interrupts
+ * disabled and from ISRs. Wraps after ~71 minutes; compare by subtraction.
+ *
+ * @return Microseconds (4 us resolution)
+ */
+uint32_t micros(void);
+
+/**
+ * @class ElapsedMicros
+ * @brief Non-blocking stopwatch on top of micros().
+ *
+ * Example:
+ *
+ *     ElapsedMicros sw;
+ *     doWork();
+ *     uint32_t cost = sw.elapsed();
+ *
+ *     static ElapsedMicros poll;
+ *     if (poll.every(250)) { ... }  // Drift-free 250 us cadence
+ */
+class ElapsedMicros {
+	public:
+	ElapsedMicros() : _start(micros()) {}
+
+	void reset() { _start = micros(); }
+	uint32_t elapsed() const { return micros() - _start; }
+	bool expired(uint32_t us) const { return elapsed() >= us; }
+
+	/**
+	 * @brief Returns true once per interval without accumulating drift.
+	 */
+	bool every(uint32_t interval_us) {
+		if (micros() - _start < interval_us) return false;
+		_start += interval_us;
+		return true;
+	}
+
+	private:
+	uint32_t _start;
+};
+
 extern Scheduler scheduler;
 
 #endif /* SCHEDULER_H_ */
\ No newline at end of file
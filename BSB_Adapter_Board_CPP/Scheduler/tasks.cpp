@@ -1,11 +1,20 @@
 #include <avr/io.h>
 #include "tasks.h"
 #include "gpio.h"
+#include "gpio_pin.h"
 #include "serial.h"
 #include "board.h"
 #include "lcd.h"
 #include <stdlib.h>
 #include "adc.h"
+#include "adc_filter.h"
+#include "adc_window.h"
+#include "adc_stats.h"
+#include "scheduler.h"
+#include "config.h"
+#include "trace.h"
+#include "metrics.h"
+#include "log.h"
 
 // Global variables for internal task state (if needed)
 
@@ -37,7 +46,7 @@ void blinkTask(void) {
 void uart3Task(void) {
 	static uint8_t uartCounter = 0;
 	uartCounter++;
-	Serial3.print(" | uartCounter = "); Serial3.println(uartCounter);
+	LOG_DEBUG(UART, "uartCounter = %u", uartCounter);
 }
 
 /**
@@ -57,41 +66,523 @@ void lcdTask()
 	char buffer[11];  // Enough for max 32-bit unsigned
 	itoa(time, buffer, 10);
 	lcd.print(buffer);
+
+	// Only the digits that changed go out to the display
+	lcd.refresh();
 }
 
-void ADCTask()
+/**
+ * @brief Serial3 console: single-character commands.
+ *
+ *   T  dump the trace ring (see trace.h), 4 records per run
+ *   M  dump all metrics (see metrics.h), 2 lines per run
+ */
+#define CONSOLE_TRACE_LINES   4   // ~16 chars each, ~65 ms at 9600 baud
+#define CONSOLE_METRIC_LINES  2   // ~30 chars each
+
+void consoleTask(void)
 {
-	uint16_t adcBuffer[16]; // Buffer for all 16 channels
-	
- adc.analogReadAllOversampled(8, adcBuffer);  // Oversample all 16 channels
+	if (!logIdle()) return;  // Dumps print directly: let log records out first
 
-// Print header
-Serial3.println("ADC Channel Readings (Oversampled):");
-Serial3.println("-----------------------------");
+	// One dump at a time; commands wait until it is through
+	if (traceDumpStep(Serial3, CONSOLE_TRACE_LINES)) return;
+	if (metricsDumpStep(Serial3, CONSOLE_METRIC_LINES)) return;
 
-// First line: A0 to A7
-for (uint8_t i = 0; i < 8; ++i) {
-	Serial3.print("A");
-	Serial3.print(i);
-	Serial3.print("=");
-	Serial3.print(adcBuffer[i]);
-	Serial3.print("\t");
+	int c = Serial3.read();
+	switch (c) {
+		case 'T':
+		traceDumpBegin();
+		break;
+
+		case 'M':
+		metricsDumpBegin();
+		break;
+	}
 }
-Serial3.println(""); // New line
 
-// Second line: A8 to A15
-for (uint8_t i = 8; i < 16; ++i) {
-	Serial3.print("A");
-	Serial3.print(i);
+/**
+ * @brief Moves buffered log records to the sink UART (see log.h).
+ */
+void logTask(void)
+{
+	logService();
+}
+
+/**
+ * @brief Writes pending configuration bytes to EEPROM (write-behind).
+ */
+void configTask(void)
+{
+	config.service();
+}
+
+/**
+ * @brief Drains the LCD command queue, one byte per 1 ms slot.
+ */
+void lcdServiceTask(void)
+{
+	lcd.service();
+}
+
+/*
+ * ADC telemetry (report-by-exception)
+ *
+ * Only channels that moved by more than their deadband since they were
+ * last sent are printed; every channel is sent again at least once per
+ * refresh interval. Each line carries the tick it was taken at:
+ *
+ *     T=123456 A3=517 A9=88          changed channels
+ *     T=180000 F A0=512 ... A15=3    full refresh
+ */
+#define ADC_REPORT_DEADBAND   2        // Default deadband (counts)
+#define ADC_REPORT_REFRESH    60000UL  // Default full refresh interval (ms)
+#define ADC_REPORT_FULL_EVERY 1000UL   // ADC_REPORT_FULL spacing (ms): ~150 chars/s at 9600 baud
+
+static uint8_t adcReportMode = ADC_REPORT_EXCEPTION;
+static uint16_t adcDeadband[16] = {
+	ADC_REPORT_DEADBAND, ADC_REPORT_DEADBAND, ADC_REPORT_DEADBAND, ADC_REPORT_DEADBAND,
+	ADC_REPORT_DEADBAND, ADC_REPORT_DEADBAND, ADC_REPORT_DEADBAND, ADC_REPORT_DEADBAND,
+	ADC_REPORT_DEADBAND, ADC_REPORT_DEADBAND, ADC_REPORT_DEADBAND, ADC_REPORT_DEADBAND,
+	ADC_REPORT_DEADBAND, ADC_REPORT_DEADBAND, ADC_REPORT_DEADBAND, ADC_REPORT_DEADBAND
+};
+static uint32_t adcRefreshInterval = ADC_REPORT_REFRESH;
+
+void adcSetReportMode(uint8_t mode)
+{
+	adcReportMode = mode;
+}
+
+void adcSetDeadband(uint8_t channel, uint16_t counts)
+{
+	if (channel < 16) adcDeadband[channel] = counts;
+}
+
+void adcSetRefreshInterval(uint32_t interval_ms)
+{
+	adcRefreshInterval = interval_ms;
+}
+
+/**
+ * @brief Prints an unsigned 32-bit value (print(int) stops at 32767).
+ */
+static void printU32(uint32_t value)
+{
+	char buffer[11];
+	ultoa(value, buffer, 10);
+	Serial3.print(buffer);
+}
+
+/**
+ * @brief Prints " A<ch>=<value>".
+ */
+static void printChannel(uint8_t channel, uint16_t value)
+{
+	Serial3.print(" A");
+	Serial3.print(channel);
 	Serial3.print("=");
-	Serial3.print(adcBuffer[i]);
-	Serial3.print("\t");
+	Serial3.print(value);
+}
+
+/**
+ * @brief Sends ADC readings from the latest sweep of the background scanner.
+ *
+ * ADC_REPORT_FULL prints all 16 channels once per ADC_REPORT_FULL_EVERY;
+ * a full report on every 100 ms call would need ~1500 chars/s, more than
+ * the ~960 chars/s a 9600 baud link carries.
+ * ADC_REPORT_EXCEPTION sends only changes beyond the deadband, plus a
+ * full refresh whenever adcRefreshInterval has passed.
+ */
+void ADCTask()
+{
+	static uint16_t lastSent[16];
+	static uint16_t lastSeq = 0;
+	static uint32_t lastRefresh = 0;
+	static bool sentOnce = false;
+
+	uint32_t now = schedulerTicks();
+	uint32_t interval = (adcReportMode == ADC_REPORT_FULL) ? ADC_REPORT_FULL_EVERY
+	                                                       : adcRefreshInterval;
+	bool full = !sentOnce || (now - lastRefresh >= interval);
+	if (adcReportMode == ADC_REPORT_FULL && !full) return;
+	if (!logIdle()) return;  // Direct print: wait until log records are out
+
+	AdcSnapshot snapshot;   // Latest sweep of the background scanner
+	if (!adc.getSnapshot(snapshot)) return;  // No complete sweep yet
+	if (snapshot.seq == lastSeq) return;     // Nothing new since the last call
+	lastSeq = snapshot.seq;
+
+	uint16_t changed = 0;  // Bit per channel to send
+	for (uint8_t ch = 0; ch < 16; ++ch) {
+		uint16_t v = snapshot.value[ch];
+		uint16_t delta = (v > lastSent[ch]) ? v - lastSent[ch] : lastSent[ch] - v;
+		if (full || delta > adcDeadband[ch]) changed |= (1U << ch);
+	}
+	if (!changed) return;
+
+	Serial3.print("T=");
+	printU32(now);
+	if (full) Serial3.print(" F");
+
+	for (uint8_t ch = 0; ch < 16; ++ch) {
+		if (changed & (1U << ch)) {
+			printChannel(ch, snapshot.value[ch]);
+			lastSent[ch] = snapshot.value[ch];
+		}
+	}
+	Serial3.println("");
+
+	if (full) {
+		lastRefresh = now;
+		sentOnce = true;
+	}
+}
+
+/**
+ * @brief Sends one summary per channel and tumbling window.
+ *
+ * Prints at most one channel per call to keep each run short:
+ *
+ *     STAT A3 w=12 n=7500 min=510 max=519 mean_x16=8230 var_x16=37
+ */
+void adcStatsTask()
+{
+	static uint16_t lastWindow[16];
+	static uint8_t next = 0;
+
+	if (!logIdle()) return;  // Direct print: wait until log records are out
+
+	for (uint8_t k = 0; k < 16; ++k) {
+		uint8_t ch = (next + k) & 15;
+		AdcStats stats;
+		if (!adcStats.getTumbling(ch, stats) || stats.window == lastWindow[ch]) continue;
+
+		lastWindow[ch] = stats.window;
+		next = (ch + 1) & 15;
+
+		Serial3.print("STAT A"); Serial3.print(ch);
+		Serial3.print(" w="); printU32(stats.window);
+		Serial3.print(" n="); printU32(stats.count);
+		Serial3.print(" min="); Serial3.print(stats.min);
+		Serial3.print(" max="); Serial3.print(stats.max);
+		Serial3.print(" mean_x16="); printU32(stats.meanQ4);
+		Serial3.print(" var_x16="); printU32(stats.varianceQ4);
+		Serial3.println("");
+		return;
+	}
 }
-Serial3.println(""); // End
 
-Serial3.println("-----------------------------");
+/**
+ * @brief Reports ADC window transitions queued by adcWindows.
+ *
+ * Registered with period SCHED_EVENT: it only runs after the comparator's
+ * handler called scheduler.notify(adcAlarmTask).
+ */
+void adcAlarmTask()
+{
+	static const char* const states[] = { "inside", "below", "above" };
+	AdcWindowEvent event;
 
+	while (adcWindows.readEvent(event)) {
+		LOG_WARN(ADC, "alarm A%u %s value=%u", event.channel,
+		         event.state <= ADC_WINDOW_ABOVE ? states[event.state] : "?", event.value);
+	}
 }
 
+/**
+ * @brief Drains the Timer1-triggered ADC stream in blocks (ripple analysis).
+ *
+ * Register instead of ADCTask when the ADC runs in ADC_MODE_TIMER:
+ *
+ *     adc.init(ADC_MODE_TIMER);
+ *     adc.startStream(0, 10000);                // 10 kSPS on A0
+ *     scheduler.addTask(adcStreamTask, 1, 5);   // ~50 samples per call
+ *
+ * Prints min/max/peak-to-peak/mean once per STREAM_WINDOW samples.
+ */
+#define STREAM_BLOCK   32
+#define STREAM_WINDOW  1000
+
+void adcStreamTask()
+{
+	static uint16_t minVal = 0xFFFF;
+	static uint16_t maxVal = 0;
+	static uint32_t sum = 0;
+	static uint16_t count = 0;
+
+	uint16_t block[STREAM_BLOCK];
+	uint8_t n;
+
+	while ((n = adc.readBlock(block, STREAM_BLOCK)) > 0) {
+		for (uint8_t i = 0; i < n; ++i) {
+			if (block[i] < minVal) minVal = block[i];
+			if (block[i] > maxVal) maxVal = block[i];
+			sum += block[i];
+		}
+		count += n;
+	}
 
+	if (count < STREAM_WINDOW || !logIdle()) return;
 
+	Serial3.print("Ripple: min="); Serial3.print(minVal);
+	Serial3.print(" max="); Serial3.print(maxVal);
+	Serial3.print(" pp="); Serial3.print(maxVal - minVal);
+	Serial3.print(" mean="); Serial3.print((int)(sum / count));
+	Serial3.print(" dropped="); Serial3.println(adc.streamOverruns());
+
+	minVal = 0xFFFF;
+	maxVal = 0;
+	sum = 0;
+	count = 0;
+}
+
+/**
+ * @brief Integer square root (bitwise, no soft-float).
+ */
+static uint32_t isqrt64(uint64_t v)
+{
+	uint64_t root = 0;
+	uint64_t bit = (uint64_t)1 << 62;
+
+	while (bit > v) bit >>= 2;
+	while (bit) {
+		if (v >= root + bit) {
+			v -= root + bit;
+			root = (root >> 1) + bit;
+		} else {
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+	return (uint32_t)root;
+}
+
+/**
+ * @brief log2(x) in Q8 (8 fraction bits) for x >= 1, by repeated squaring.
+ */
+static uint16_t log2Q8(uint32_t x)
+{
+	if (x == 0) return 0;
+
+	uint16_t result = 31 << 8;
+	while (!(x & 0x80000000UL)) {
+		x <<= 1;
+		result -= 1 << 8;
+	}
+
+	uint32_t m = x >> 16;  // Mantissa in Q15, [1, 2)
+	for (uint8_t bit = 0x80; bit; bit >>= 1) {
+		m = (m * m) >> 15;
+		if (m >= (2UL << 15)) {
+			m >>= 1;
+			result |= bit;
+		}
+	}
+	return result;
+}
+
+/**
+ * @brief Characterizes ADC noise against conversion time for 10-13 bits,
+ * busy-wait conversions versus ADC Noise Reduction sleep.
+ *
+ * Pauses the background scanner and takes BENCH_READINGS decimated readings
+ * of one channel per resolution and path. Prints the time per reading, the
+ * standard deviation in thousandths of a native 10-bit LSB and the
+ * effective number of bits, ENOB = 10 - log2(sd * sqrt(12)), times 100:
+ *
+ *     path=busy bits=12 samples=16 t_us=1672 sd_mLSB=180 enob_x100=1064
+ *
+ * Feed a quiet, fixed voltage for meaningful numbers. Takes ~1 s, so call
+ * it from Board_Init() or a task with a matching runtime budget.
+ */
+#define BENCH_READINGS 32
+
+void adcNoiseBenchmark(uint8_t channel)
+{
+	adc.stopScan();
+	Serial3.println("ADC noise vs. sample time:");
+	uint16_t fallbacks = adc.sleepFallbacks();
+
+	for (uint8_t sleep = 0; sleep < 2; ++sleep) {
+		for (uint8_t bits = 10; bits <= 13; ++bits) {
+			uint8_t n = bits - 10;
+			uint32_t sum = 0;
+			uint64_t sumSq = 0;
+
+			while (Serial3.txBusy());  // Let the last line go out first
+
+			ElapsedMicros stopwatch;
+			for (uint8_t i = 0; i < BENCH_READINGS; ++i) {
+				uint16_t v = adc.analogReadDecimated(channel, bits, sleep);
+				sum += v;
+				sumSq += (uint32_t)v * v;
+			}
+			uint32_t perReading = stopwatch.elapsed() / BENCH_READINGS;
+
+			// N^2 * variance, in units of (2^-n LSB)^2
+			uint64_t varN2 = sumSq * BENCH_READINGS - (uint64_t)sum * sum;
+			uint32_t sd = (isqrt64(varN2 * 1000000ULL) / BENCH_READINGS) >> n;
+
+			// Quantization noise alone (0.289 LSB) gives the full resolution
+			int16_t enobQ8 = bits << 8;
+			if (sd > 0 && sd < 1000000UL) {
+				int16_t e = (10 << 8) + log2Q8(1000000UL) - log2Q8(sd * 3464UL);
+				if (e < enobQ8) enobQ8 = e;
+			}
+
+			Serial3.print(sleep ? "path=sleep" : "path=busy");
+			Serial3.print(" bits="); Serial3.print(bits);
+			Serial3.print(" samples="); Serial3.print(1 << (2 * n));
+			Serial3.print(" t_us="); Serial3.print((int)perReading);
+			Serial3.print(" sd_mLSB="); Serial3.print((int)sd);
+			Serial3.print(" enob_x100="); Serial3.println((int)((int32_t)enobQ8 * 100 / 256));
+		}
+	}
+
+	Serial3.print("Sleep fallbacks: ");
+	Serial3.println((int)(adc.sleepFallbacks() - fallbacks));
+	adc.resumeScan();
+}
+
+/**
+ * @brief Measures the per-sample cost of each ADC filter stage.
+ *
+ * Runs FILTER_BENCH_SAMPLES samples through a private filter bank per
+ * configuration and prints CPU cycles per sample (including ~10 cycles of
+ * loop overhead and the Timer0 tick).
+ */
+#define FILTER_BENCH_SAMPLES 1000
+
+void adcFilterBenchmark()
+{
+	static AdcFilterBank bench;
+	static const AdcFilterConfig configs[] = {
+		{0, 0, 0}, {3, 0, 0}, {5, 0, 0}, {0, 3, 0}, {0, 0, 32}, {5, 3, 32}
+	};
+	static const char* const names[] = {
+		"bypass", "median3", "median5", "ema", "iir", "chain"
+	};
+
+	Serial3.println("ADC filter cost per sample:");
+
+	for (uint8_t k = 0; k < sizeof(configs) / sizeof(configs[0]); ++k) {
+		bench.configure(0, configs[k]);
+		bench.process(0, 512);  // Prime
+
+		ElapsedMicros stopwatch;
+		for (uint16_t i = 0; i < FILTER_BENCH_SAMPLES; ++i) {
+			bench.process(0, 500 + (i & 31));
+		}
+		uint32_t cycles = stopwatch.elapsed() * (F_CPU / 1000000UL) / FILTER_BENCH_SAMPLES;
+
+		Serial3.print(names[k]);
+		Serial3.print(" cycles="); Serial3.println((int)cycles);
+	}
+}
+
+/**
+ * @brief Compares gpio.cpp calls with Pin<> on the LED pin.
+ *
+ * Runs GPIO_BENCH_LOOPS set/clear pairs per variant and prints CPU cycles
+ * per pair with the empty-loop overhead subtracted. The LED flickers
+ * briefly and ends up off.
+ */
+#define GPIO_BENCH_LOOPS 1000
+
+static uint32_t gpioBenchCycles(uint32_t us, uint32_t baseUs)
+{
+	uint32_t net = (us > baseUs) ? us - baseUs : 0;
+	return net * (F_CPU / 1000000UL) / GPIO_BENCH_LOOPS;
+}
+
+void gpioBenchmark(void)
+{
+	typedef Pin<LED_P2> Led;
+
+	ElapsedMicros stopwatch;
+	for (uint16_t i = 0; i < GPIO_BENCH_LOOPS; ++i) {
+		asm volatile("");
+	}
+	uint32_t baseUs = stopwatch.elapsed();
+
+	stopwatch.reset();
+	for (uint16_t i = 0; i < GPIO_BENCH_LOOPS; ++i) {
+		digitalWrite(LED_P2, HIGH);
+		digitalWrite(LED_P2, LOW);
+	}
+	uint32_t writeUs = stopwatch.elapsed();
+
+	stopwatch.reset();
+	for (uint16_t i = 0; i < GPIO_BENCH_LOOPS; ++i) {
+		Led::set();
+		Led::clear();
+	}
+	uint32_t pinUs = stopwatch.elapsed();
+
+	stopwatch.reset();
+	for (uint16_t i = 0; i < GPIO_BENCH_LOOPS; ++i) {
+		Led::toggle();
+		Led::toggle();
+	}
+	uint32_t toggleUs = stopwatch.elapsed();
+
+	Led::set();  // LED is active low: off
+
+	Serial3.println("GPIO cycles per set+clear pair:");
+	Serial3.print("digitalWrite "); Serial3.println((int)gpioBenchCycles(writeUs, baseUs));
+	Serial3.print("Pin<> set/clear "); Serial3.println((int)gpioBenchCycles(pinUs, baseUs));
+	Serial3.print("Pin<> toggle x2 "); Serial3.println((int)gpioBenchCycles(toggleUs, baseUs));
+}
+
+/**
+ * @brief Times a full 16x2 redraw with fixed delays and with busy polling,
+ * then a diff refresh where one character changed.
+ *
+ * Prints elapsed microseconds and bus transfers per variant, and the
+ * time a queued refresh() spends in the caller. Polling stays enabled
+ * afterwards if RW is wired; queued mode is restored.
+ */
+static void lcdBenchRefresh(const char* name, bool full)
+{
+	if (full) lcd.invalidate();
+	ElapsedMicros stopwatch;
+	uint8_t transfers = lcd.refresh();
+	uint32_t us = stopwatch.elapsed();
+
+	Serial3.print(name); printU32(us);
+	Serial3.print(" us, transfers="); Serial3.println(transfers);
+}
+
+void lcdBenchmark(void)
+{
+	bool wasQueued = lcd.queued();
+
+	lcd.setQueued(false);  // Sends whatever is still queued
+
+	lcd.clear();
+	for (uint8_t row = 0; row < 2; ++row) {
+		lcd.setCursor(0, row);
+		for (uint8_t col = 0; col < 16; ++col) {
+			lcd.print((char)('A' + ((row * 16 + col) % 26)));
+		}
+	}
+
+	Serial3.println("LCD 16x2 refresh:");
+
+	lcd.setBusyPolling(false);
+	lcdBenchRefresh("full timed ", true);
+
+	lcd.setBusyPolling(true);
+	if (lcd.busyPolling()) {
+		lcdBenchRefresh("full busy flag ", true);
+	} else {
+		Serial3.println("busy flag n/a (RW not wired)");
+	}
+
+	lcd.setCursor(15, 0);
+	lcd.print('#');
+	lcdBenchRefresh("diff 1 cell ", false);
+
+	lcd.setQueued(true);
+	lcdBenchRefresh("full queued ", true);
+	lcd.setQueued(wasQueued);
+}
@@ -1,6 +1,11 @@
 #ifndef TASKS_H_
 #define TASKS_H_
 
+#include <stdint.h>
+
+#define ADC_REPORT_FULL       0   // ADCTask prints every channel once per second
+#define ADC_REPORT_EXCEPTION  1   // ADCTask prints changed channels only
+
 #ifdef __cplusplus
 extern "C" {
 	#endif
@@ -10,7 +15,21 @@ extern "C" {
 	void blinkTask(void);
 	void uart3Task(void);
 	void lcdTask(void);
+	void lcdServiceTask(void);
+	void configTask(void);
+	void consoleTask(void);
+	void logTask(void);
 	void ADCTask(void);
+	void adcAlarmTask(void);
+	void adcStatsTask(void);
+	void adcSetReportMode(uint8_t mode);
+	void adcSetDeadband(uint8_t channel, uint16_t counts);
+	void adcSetRefreshInterval(uint32_t interval_ms);
+	void adcStreamTask(void);
+	void adcNoiseBenchmark(uint8_t channel);
+	void adcFilterBenchmark(void);
+	void gpioBenchmark(void);
+	void lcdBenchmark(void);
 
 	#ifdef __cplusplus
 }
@@ -0,0 +1,188 @@
+#include "watchdog.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/wdt.h>
+#include "log.h"
+#include "trace.h"
+#include "postmortem.h"
+
+#define WDT_RECORD_MAGIC 0xB5AD
+
+/**
+ * @brief Diagnosis record kept across warm resets.
+ *
+ * Placed in .noinit so the C runtime does not clear it at startup. The
+ * magic word tells a valid record from power-on garbage.
+ */
+struct ResetRecord {
+	uint16_t magic;    // WDT_RECORD_MAGIC once cause/task are valid
+	uint8_t  cause;    // WDT_CAUSE_xx
+	uint8_t  task;     // Task slot blamed for the reset
+	uint8_t  running;  // Slot currently executing in Scheduler::run()
+};
+
+static ResetRecord resetRecord __attribute__((section(".noinit")));
+static uint8_t bootMcusr __attribute__((section(".noinit")));
+
+Watchdog watchdog;
+
+// -----------------------------------------------------------------------------
+// Early Startup Hook
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Runs from .init3, before static constructors and main().
+ *
+ * After a watchdog reset the WDT stays enabled with the shortest timeout, so
+ * it must be switched off before the C runtime spends time on initialization.
+ * MCUSR is saved first because WDRF has to be cleared to disable the WDT.
+ */
+#ifdef __AVR__
+void wdtEarlyInit(void) __attribute__((naked, used, section(".init3")));
+#else
+void wdtEarlyInit(void);  // Host build: no .init3, and naked code has no stack at -O0
+#endif
+void wdtEarlyInit(void) {
+	bootMcusr = MCUSR;
+	MCUSR = 0;
+	wdt_disable();
+}
+
+// -----------------------------------------------------------------------------
+// Public API
+// -----------------------------------------------------------------------------
+
+void Watchdog::begin(uint8_t timeout) {
+	if (!_armed) {
+		// Capture the diagnosis of the previous reset, then start a fresh record
+		_mcusr = bootMcusr;
+		if (_mcusr & (1 << WDRF)) {
+			bool valid = (resetRecord.magic == WDT_RECORD_MAGIC);
+			_cause = valid ? resetRecord.cause : WDT_CAUSE_TIMEOUT;
+			_task  = valid ? resetRecord.task : WDT_NO_TASK;
+		}
+		resetRecord.magic = 0;
+		resetRecord.cause = WDT_CAUSE_NONE;
+		resetRecord.task = WDT_NO_TASK;
+		resetRecord.running = WDT_NO_TASK;
+		postmortem.begin(_mcusr, _cause, _task);
+		_armed = true;
+	}
+
+	// WDP3 lives apart from WDP2:0 in WDTCSR
+	_prescaler = (timeout & 0x07) | ((timeout & 0x08) ? (1 << WDP3) : 0);
+	arm();
+}
+
+/**
+ * @brief Timed sequence: interrupt + reset mode with the begin() timeout.
+ */
+void Watchdog::arm() {
+	uint8_t sreg = SREG;
+	cli();
+	wdt_reset();
+	WDTCSR = (1 << WDCE) | (1 << WDE);
+	WDTCSR = (1 << WDIE) | (1 << WDE) | _prescaler;
+	SREG = sreg;
+}
+
+/**
+ * Only called while all critical tasks are healthy. A cause flagged
+ * earlier is then stale: it is dropped so a later, unrelated reset is not
+ * blamed on it, and the interrupt stage used up by WDT_vect is re-armed.
+ */
+void Watchdog::feed() {
+	wdt_reset();
+	if (resetRecord.magic != WDT_RECORD_MAGIC) return;
+
+	uint8_t sreg = SREG;
+	cli();
+	resetRecord.magic = 0;
+	resetRecord.cause = WDT_CAUSE_NONE;
+	resetRecord.task = WDT_NO_TASK;
+	arm();
+	SREG = sreg;
+}
+
+void Watchdog::enterTask(uint8_t slot) {
+	resetRecord.running = slot;
+}
+
+void Watchdog::leaveTask() {
+	resetRecord.running = WDT_NO_TASK;
+}
+
+void Watchdog::flag(uint8_t cause, uint8_t slot) {
+	if (resetRecord.magic == WDT_RECORD_MAGIC) return;  // Keep the first cause
+
+	resetRecord.cause = cause;
+	resetRecord.task = slot;
+	resetRecord.magic = WDT_RECORD_MAGIC;
+	postmortem.log(PM_WDT_CAUSE, cause, slot);
+}
+
+void Watchdog::forceReset(uint8_t cause, uint8_t slot) {
+	cli();
+	flag(cause, slot);
+
+	// Shortest timeout without the interrupt stage, then wait for it
+	wdt_enable(WDTO_15MS);
+	for (;;) {}
+}
+
+bool Watchdog::wasWatchdogReset() {
+	return (_mcusr & (1 << WDRF)) != 0;
+}
+
+uint8_t Watchdog::lastCause() {
+	return _cause;
+}
+
+uint8_t Watchdog::lastTask() {
+	return _task;
+}
+
+/**
+ * WARN level, so release builds (LOG_LEVEL_WARN) keep the diagnosis.
+ */
+void Watchdog::report() {
+	const char* source;
+	if (_mcusr & (1 << WDRF))       source = "Watchdog";
+	else if (_mcusr & (1 << BORF))  source = "Brown-out";
+	else if (_mcusr & (1 << EXTRF)) source = "External";
+	else if (_mcusr & (1 << PORF))  source = "Power-on";
+	else if (_mcusr & (1 << JTRF))  source = "JTAG";
+	else                            source = "Unknown";
+
+	if (!wasWatchdogReset()) {
+		LOG_WARN(BOARD, "Reset cause: %s", source);
+		return;
+	}
+
+	const char* reason;
+	switch (_cause) {
+		case WDT_CAUSE_OVERRUN: reason = "Overrun"; break;
+		case WDT_CAUSE_STARVED: reason = "Starved"; break;
+		default:                reason = "Timeout"; break;
+	}
+	if (_task == WDT_NO_TASK) {
+		LOG_WARN(BOARD, "Reset cause: %s | Reason=%s | Task=none", source, reason);
+	} else {
+		LOG_WARN(BOARD, "Reset cause: %s | Reason=%s | Task=%u", source, reason, _task);
+	}
+}
+
+// -----------------------------------------------------------------------------
+// Watchdog Interrupt
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief First watchdog timeout: blame the running task.
+ * The hardware clears WDIE on entry, so the next timeout resets the MCU
+ * unless feed() re-arms the interrupt stage after a recovery.
+ */
+ISR(WDT_vect) {
+	TRACE_ISR_ENTER_EVT(TRACE_ISR_WDT);
+	watchdog.flag(WDT_CAUSE_TIMEOUT, resetRecord.running);
+	TRACE_ISR_EXIT_EVT(TRACE_ISR_WDT);
+}
@@ -0,0 +1,76 @@
+#ifndef WATCHDOG_H_
+#define WATCHDOG_H_
+
+#include <stdint.h>
+#include <avr/wdt.h>
+
+/**
+ * @file watchdog.h
+ * @brief Hardware watchdog backstop for the cooperative scheduler.
+ *
+ * The AVR watchdog runs in "interrupt + reset" mode: the first timeout enters
+ * WDT_vect, which stores the diagnosis, and the second one resets the MCU.
+ * The diagnosis lives in a .noinit record that survives the warm reset, so
+ * the cause can be reported once the board is back up.
+ *
+ * The scheduler feeds the watchdog only while all critical tasks are healthy
+ * (see Scheduler::run()), and reports the running task through enterTask()
+ * and leaveTask().
+ */
+
+// Reset causes stored in the .noinit record
+#define WDT_CAUSE_NONE      0  // No watchdog event recorded
+#define WDT_CAUSE_TIMEOUT   1  // Hardware watchdog expired (nobody fed it)
+#define WDT_CAUSE_OVERRUN   2  // Critical task exceeded its max runtime
+#define WDT_CAUSE_STARVED   3  // Critical task missed its heartbeat
+
+#define WDT_NO_TASK         0xFF
+
+class Watchdog {
+	public:
+	/**
+	 * @brief Captures the reset cause and arms the hardware watchdog.
+	 *
+	 * @param timeout WDTO_xx constant from <avr/wdt.h> (default 1 s)
+	 */
+	void begin(uint8_t timeout = WDTO_1S);
+
+	/**
+	 * @brief Resets the hardware watchdog timer; after a recovery also
+	 * clears the flagged cause and re-arms the interrupt stage.
+	 */
+	void feed();
+	void enterTask(uint8_t slot);  // Scheduler is about to call task 'slot'
+	void leaveTask();              // Task returned to the scheduler
+
+	/**
+	 * @brief Records a cause without resetting; the next WDT timeout keeps it.
+	 * The first flagged cause wins until feed() finds all critical tasks
+	 * healthy again, or the record is read at boot.
+	 */
+	void flag(uint8_t cause, uint8_t slot);
+
+	/**
+	 * @brief Records the cause and forces an immediate (15 ms) reset.
+	 * Safe to call from ISR context. Never returns.
+	 */
+	void forceReset(uint8_t cause, uint8_t slot);
+
+	bool wasWatchdogReset();       // True if the last reset came from the WDT
+	uint8_t lastCause();           // WDT_CAUSE_xx of the last reset
+	uint8_t lastTask();            // Task slot running at the last reset
+	void report();                 // Log the reset diagnosis (after the greeting)
+
+	private:
+	void arm();
+
+	uint8_t _mcusr = 0;            // MCUSR captured at boot
+	uint8_t _cause = WDT_CAUSE_NONE;
+	uint8_t _task = WDT_NO_TASK;
+	uint8_t _prescaler = 0;        // WDP3:0 bits of the begin() timeout
+	bool _armed = false;
+};
+
+extern Watchdog watchdog;
+
+#endif /* WATCHDOG_H_ */
@@ -0,0 +1,153 @@
+/*
+ * Host Micro-Benchmarks
+ * ---------------------
+ *
+ * Times the hot paths of the scheduler, the formatting code and the
+ * drivers on the host. Two numbers per case:
+ *
+ *   ns/op   host wall clock; compare runs on the same machine only
+ *   cyc/op  simulated ATmega2560 cycles spent on register accesses and
+ *           waits (see host_sim.h); computation itself is not counted
+ *
+ * Use them to compare before/after a change, not as AVR timings.
+ *
+ *     ./host_bench            full run
+ *     ./host_bench --quick    few iterations (ctest smoke run)
+ *     ./host_bench lcd        only cases whose name contains "lcd"
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include "host_sim.h"
+#include "scheduler.h"
+#include "serial.h"
+#include "log.h"
+#include "metrics.h"
+#include "lcd.h"
+#include "gpio.h"
+#include "gpio_group.h"
+
+static LCD display(APG1, APB4, APE6, APH0, APH1, APH2, APH3, APH4, APH5, APH6, APH7);
+static PinGroup bus;
+static uint16_t counter;
+
+static void idleTask() {}
+
+static void setupScheduler() {
+    scheduler.init();
+    scheduler.addTask(idleTask, 1, 1000, 10);
+    scheduler.addTask(idleTask, 2, 500, 10);
+    scheduler.addTask(idleTask, 3, 250, 10);
+    scheduler.start();
+}
+
+static void setupLcd() {
+    display.setQueued(false);
+    display.begin(16, 2);
+    display.setCursor(0, 0);
+    display.print("LCD Test - 0");
+    display.refresh();
+}
+
+static void setupBus() {
+    static const uint8_t pins[8] = { APH0, APH1, APH2, APH3, APH4, APH5, APH6, APH7 };
+    bus.begin(pins, 8);
+    bus.output();
+}
+
+static void setupScatteredBus() {
+    static const uint8_t pins[4] = { APB7, APA0, APB0, APE6 };
+    bus.begin(pins, 4);
+    bus.output();
+}
+
+static void setupLog() {
+    logSetSink(&Serial3);
+}
+
+static void runScheduler()  { scheduler.run(); }
+static void tickScheduler() { scheduler.tick(); }
+static void readMicros()    { volatile uint32_t us = micros(); (void)us; }
+
+static void printInt() {
+    Serial3.print(-12345);
+}
+
+static void formatLog() {
+    LOG_INFO(BOARD, "ch%u=%u mV", 3, counter++);
+    logSetSink(0);               // Discard the record so the ring never fills
+    logSetSink(&Serial3);
+}
+
+static void snapshotMetric() {
+    volatile uint32_t value = metricGet(METRIC_SCHED_DISPATCHES);
+    (void)value;
+}
+
+static void lcdUnchanged() {
+    display.refresh();
+}
+
+static void lcdCounter() {
+    char digits[6];
+    utoa(counter++, digits, 10);
+    display.setCursor(11, 0);
+    display.print(digits);
+    display.refresh();
+}
+
+static void groupWrite() { bus.write(counter++); }
+static void pinWrite()   { digitalWrite(APB7, counter++ & 1); }
+
+struct BenchCase {
+    const char* name;
+    void (*setup)();
+    void (*body)();
+    uint32_t iterations;
+};
+
+static const BenchCase cases[] = {
+    { "sched.run_idle",      setupScheduler,    runScheduler,   200000 },
+    { "sched.tick",          setupScheduler,    tickScheduler,  200000 },
+    { "sched.micros",        setupScheduler,    readMicros,     200000 },
+    { "serial.print_int",    0,                 printInt,        20000 },
+    { "log.write",           setupLog,          formatLog,      100000 },
+    { "metrics.get",         0,                 snapshotMetric, 200000 },
+    { "lcd.refresh_same",    setupLcd,          lcdUnchanged,   100000 },
+    { "lcd.refresh_counter", setupLcd,          lcdCounter,      20000 },
+    { "gpio.group_aligned",  setupBus,          groupWrite,     200000 },
+    { "gpio.group_scatter",  setupScatteredBus, groupWrite,     200000 },
+    { "gpio.digital_write",  0,                 pinWrite,       200000 },
+};
+
+int main(int argc, char** argv) {
+    bool quick = false;
+    const char* filter = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) quick = true;
+        else filter = argv[i];
+    }
+
+    printf("%-22s %10s %10s %10s\n", "case", "iters", "ns/op", "cyc/op");
+    for (const BenchCase& c : cases) {
+        if (filter && !strstr(c.name, filter)) continue;
+
+        hostReset();
+        Serial3.begin(1000000);  // Fastest rate the divider gives at 16 MHz
+        if (c.setup) c.setup();
+
+        uint32_t iterations = quick ? c.iterations / 100 : c.iterations;
+        uint64_t cycles = hostCycles();
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < iterations; i++) c.body();
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        cycles = hostCycles() - cycles;
+
+        double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        printf("%-22s %10u %10.1f %10.1f\n", c.name, (unsigned)iterations,
+               ns / iterations, (double)cycles / iterations);
+    }
+    return 0;
+}
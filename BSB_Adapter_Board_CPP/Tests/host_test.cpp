@@ -0,0 +1,62 @@
+#include "host_test.h"
+#include <stdio.h>
+#include <string.h>
+#include "scheduler.h"
+
+static HostTest* firstTest = 0;
+static HostTest* lastTest = 0;
+static int failures = 0;
+
+HostTest::HostTest(const char* name, void (*func)()) : name(name), func(func), next(0) {
+    // Registration order = definition order within the file
+    if (lastTest) lastTest->next = this;
+    else          firstTest = this;
+    lastTest = this;
+}
+
+void hostCheck(bool ok, const char* expr, const char* file, int line) {
+    if (ok) return;
+    printf("  %s:%d: CHECK(%s) failed\n", file, line, expr);
+    failures++;
+}
+
+void hostCheckEq(long long actual, long long expected, const char* expr, const char* file, int line) {
+    if (actual == expected) return;
+    printf("  %s:%d: %s == %lld, expected %lld\n", file, line, expr, actual, expected);
+    failures++;
+}
+
+void hostCheckStr(const std::string& actual, const std::string& expected, const char* expr,
+                  const char* file, int line) {
+    if (actual == expected) return;
+    printf("  %s:%d: %s == \"%s\", expected \"%s\"\n", file, line, expr, actual.c_str(), expected.c_str());
+    failures++;
+}
+
+void hostRunScheduler(uint32_t ms) {
+    while (ms--) {
+        hostAdvanceUs(1000);
+        scheduler.run();
+    }
+}
+
+int main(int argc, char** argv) {
+    int failed = 0;
+    int run = 0;
+
+    for (HostTest* t = firstTest; t; t = t->next) {
+        if (argc > 1 && strcmp(argv[1], t->name) != 0) continue;
+
+        int before = failures;
+        hostReset();
+        t->func();
+        run++;
+
+        bool ok = failures == before;
+        if (!ok) failed++;
+        printf("%s %s\n", ok ? "[ OK ]" : "[FAIL]", t->name);
+    }
+
+    printf("%d test(s), %d failed\n", run, failed);
+    return (failed || !run) ? 1 : 0;
+}
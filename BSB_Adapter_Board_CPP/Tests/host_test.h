@@ -0,0 +1,56 @@
+/*
+ * Host Unit Tests
+ * ---------------
+ *
+ * A small self-registering harness for the host build (no external
+ * dependencies). Every test starts from hostReset(); firmware globals
+ * (scheduler, Serial3, config, ...) keep their state between the tests of
+ * one executable, so each test removes what it added.
+ *
+ *     HOST_TEST(serial_prints_negative_numbers) {
+ *         Serial3.begin(115200);
+ *         Serial3.print(-42);
+ *         hostAdvanceUs(1000);
+ *         CHECK_STR(hostUartOutput(3), "-42");
+ *     }
+ *
+ * Run one test by name: ./test_serial serial_prints_negative_numbers
+ */
+
+#ifndef HOST_TEST_H_
+#define HOST_TEST_H_
+
+#include <string>
+#include "host_sim.h"
+
+struct HostTest {
+    HostTest(const char* name, void (*func)());
+
+    const char* name;
+    void (*func)();
+    HostTest* next;
+};
+
+void hostCheck(bool ok, const char* expr, const char* file, int line);
+void hostCheckEq(long long actual, long long expected, const char* expr, const char* file, int line);
+void hostCheckStr(const std::string& actual, const std::string& expected, const char* expr,
+                  const char* file, int line);
+
+#define HOST_TEST(name) \
+    static void name(); \
+    static HostTest name##_registration(#name, name); \
+    static void name()
+
+#define CHECK(cond)               hostCheck((cond), #cond, __FILE__, __LINE__)
+#define CHECK_EQ(actual, expected) \
+    hostCheckEq((long long)(actual), (long long)(expected), #actual, __FILE__, __LINE__)
+#define CHECK_STR(actual, expected) \
+    hostCheckStr((actual), (expected), #actual, __FILE__, __LINE__)
+
+/**
+ * @brief Advances simulated time in 1 ms steps, calling scheduler.run()
+ * after each, like the main loop would.
+ */
+void hostRunScheduler(uint32_t ms);
+
+#endif /* HOST_TEST_H_ */
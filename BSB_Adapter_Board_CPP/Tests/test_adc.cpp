@@ -0,0 +1,145 @@
+#include "host_test.h"
+#include <avr/interrupt.h>
+#include "adc.h"
+#include "adc_filter.h"
+#include "adc_stats.h"
+
+HOST_TEST(single_read_returns_input) {
+    adc.setResolution(10);
+    adc.init(ADC_MODE_SINGLE);
+    hostAdcSetInput(3, 512);
+    hostAdcSetInput(9, 77);
+
+    CHECK_EQ(adc.analogRead(3), 512);
+    CHECK_EQ(adc.analogRead(9), 77);   // ADC8-15 through MUX5
+}
+
+HOST_TEST(resolution_scales_result) {
+    adc.setResolution(8);
+    adc.init(ADC_MODE_SINGLE);
+    hostAdcSetInput(0, 1023);
+    CHECK_EQ(adc.analogRead(0), 255);
+
+    adc.setResolution(12);              // 16 conversions, decimated
+    hostAdcSetInput(0, 100);
+    CHECK_EQ(adc.analogRead(0), 400);
+    adc.setResolution(10);
+}
+
+HOST_TEST(conversion_takes_thirteen_adc_clocks) {
+    adc.setResolution(10);
+    adc.init(ADC_MODE_SINGLE);          // 125 kHz: 104 us per conversion
+    adc.analogRead(1);
+
+    uint32_t before = hostAdcConversions();
+    uint64_t start = hostCycles();
+    adc.analogRead(2);
+    uint32_t conversions = hostAdcConversions() - before;
+    uint32_t us = (hostCycles() - start) / 16;
+
+    CHECK(conversions >= 1);
+    CHECK(us >= conversions * 104 && us <= conversions * 104 + 20);
+}
+
+HOST_TEST(free_running_updates_latest) {
+    adc.setResolution(10);
+    hostAdcSetInput(0, 300);
+    adc.init(ADC_MODE_FREE);
+
+    hostAdvanceUs(1000);
+    CHECK(hostAdcConversions() >= 8);
+    CHECK_EQ(adc.readLatest(), 300);
+
+    hostAdcSetInput(0, 301);
+    hostAdvanceUs(300);
+    CHECK_EQ(adc.readLatest(), 301);
+    adc.init(ADC_MODE_SINGLE);
+}
+
+HOST_TEST(scan_fills_snapshot_from_isr) {
+    static const uint8_t channels[3] = { 0, 4, 12 };
+    adc.setResolution(10);
+    hostAdcSetInput(0, 10);
+    hostAdcSetInput(4, 400);
+    hostAdcSetInput(12, 1000);
+
+    adc.init(ADC_MODE_SCAN);
+    sei();
+    adc.startScan(channels, 3, 1);
+    hostAdvanceUs(20000);
+
+    AdcSnapshot snap;
+    CHECK(adc.getSnapshot(snap));
+    CHECK(adc.scanSequence() > 0);
+    CHECK_EQ(snap.value[0], 10);
+    CHECK_EQ(snap.value[4], 400);
+    CHECK_EQ(snap.value[12], 1000);
+
+    adc.stopScan();
+    cli();
+    adc.init(ADC_MODE_SINGLE);
+}
+
+HOST_TEST(median_rejects_single_spike) {
+    AdcFilterBank filters;
+    const AdcFilterConfig config = { 3, 0, 0 };
+    filters.configure(4, config);
+
+    CHECK_EQ(filters.process(4, 100), 100);  // Primes the history
+    CHECK_EQ(filters.process(4, 1000), 100);
+    CHECK_EQ(filters.process(4, 102), 102);
+    CHECK_EQ(filters.process(4, 104), 104);  // Spike has left the window
+    CHECK_EQ(filters.process(4, 1000), 104);
+    CHECK_EQ(filters.process(4, 1000), 1000);  // Two in a row pass
+}
+
+HOST_TEST(ema_steps_toward_input) {
+    AdcFilterBank filters;
+    const AdcFilterConfig config = { 0, 2, 0 };  // alpha = 1/4
+    filters.configure(0, config);
+
+    CHECK_EQ(filters.process(0, 0), 0);
+    CHECK_EQ(filters.process(0, 400), 100);
+    CHECK_EQ(filters.process(0, 400), 175);
+    for (uint8_t i = 0; i < 60; ++i) filters.process(0, 400);
+    CHECK_EQ(filters.process(0, 400), 400);  // Q4 state reaches the input
+
+    filters.configure(0, config);            // Reset: primes again
+    CHECK_EQ(filters.process(0, 10), 10);
+}
+
+HOST_TEST(iir_uses_alpha_per_256) {
+    AdcFilterBank filters;
+    const AdcFilterConfig config = { 0, 0, 64 };  // alpha = 1/4
+    filters.configure(1, config);
+
+    filters.process(1, 0);
+    CHECK_EQ(filters.process(1, 400), 100);
+    CHECK_EQ(filters.process(1, 400), 175);
+    CHECK_EQ(filters.process(ADC_NUM_CHANNELS, 77), 77);  // Bad channel: unfiltered
+}
+
+HOST_TEST(low_pass_alpha_handles_high_cutoffs) {
+    CHECK_EQ(AdcFilterBank::lowPassAlpha(1000, 100000), 15);         // 1 Hz at 100 Hz
+    CHECK_EQ(AdcFilterBank::lowPassAlpha(10000000, 1000000000), 15); // Same ratio in kHz
+    CHECK_EQ(AdcFilterBank::lowPassAlpha(5000000, 10000000), 194);   // 5 kHz at 10 kHz
+}
+
+HOST_TEST(stats_slots_follow_configured_channels) {
+    AdcStatsBank stats;
+    for (uint8_t ch = 0; ch < ADC_STATS_SLOTS; ++ch) {
+        CHECK(stats.configure(ch, 2, 1));
+    }
+    CHECK(!stats.configure(9, 2, 1));         // Pool full
+    CHECK(stats.configure(1, 0, 1));          // Frees A1's slot
+    CHECK(stats.configure(9, 2, 1));
+
+    stats.add(9, 100);
+    stats.add(9, 102);
+    stats.add(1, 500);                        // No slot: ignored
+    AdcStats out;
+    CHECK(stats.getTumbling(9, out));
+    CHECK_EQ(out.count, 2);
+    CHECK_EQ(out.meanQ4, 101 * 16);
+    CHECK(!stats.getTumbling(1, out));
+}
@@ -0,0 +1,69 @@
+#include "host_test.h"
+#include "board.h"
+#include "scheduler.h"
+#include "serial.h"
+
+static std::string runFor(uint16_t ms) {
+    std::string out;
+    for (uint16_t i = 0; i < ms; i++) {
+        hostRunScheduler(1);
+        out += hostUartOutput(3);
+    }
+    return out;
+}
+
+// Line n without its "<ms> " prefix
+static std::string lineAt(const std::string& out, uint8_t n) {
+    size_t start = 0;
+    while (n-- && start != std::string::npos) {
+        start = out.find("\r\n", start);
+        if (start != std::string::npos) start += 2;
+    }
+    if (start == std::string::npos) return "";
+    size_t end = out.find("\r\n", start);
+    std::string line = out.substr(start, end == std::string::npos ? std::string::npos : end - start);
+    size_t space = line.find(' ');
+    return space == std::string::npos ? line : line.substr(space + 1);
+}
+
+// Whole line containing text, empty if it is not there or split
+static std::string lineWith(const std::string& out, const char* text) {
+    size_t at = out.find(text);
+    if (at == std::string::npos) return "";
+    size_t start = out.rfind("\r\n", at);
+    start = (start == std::string::npos) ? 0 : start + 2;
+    size_t end = out.find("\r\n", at);
+    std::string line = out.substr(start, end - start);
+    return (line.find("T=") == std::string::npos) ? line : "";
+}
+
+// The whole firmware as main() runs it: bring-up task, then all tasks.
+// One test, since scheduler.begin() cannot be undone between tests.
+HOST_TEST(board_boots_and_answers_console) {
+    hostAdcSetInput(0, 512);
+
+    Board_Init();
+    scheduler.begin();
+
+    // Serial3 users start right away; the LCD power-up needs
+    // lcdServiceTask every ms, so no boot report may block it
+    std::string out;
+    while (!scheduler.isReady(BOARD_READY_LCD) && schedulerTicks() < 1000) {
+        out += runFor(1);
+        if (schedulerTicks() == 5) CHECK(scheduler.isReady(BOARD_READY_SERIAL));
+    }
+    CHECK(schedulerTicks() < 100);
+    out += runFor(1000);
+
+    // Greeting first and whole: direct Serial3 writers wait for the log
+    CHECK_STR(lineAt(out, 0), "I BOARD: BSB_Adapter_Paltine sagt Hallo...!");
+    CHECK_STR(lineAt(out, 1), "W BOARD: Reset cause: Unknown");
+    CHECK(lineWith(out, "I BOARD: ready after ").size() > 0);
+    CHECK(scheduler.isReady(BOARD_READY_SERIAL | BOARD_READY_ADC | BOARD_READY_LCD));
+
+    hostUartInject(3, "M");
+    out = runFor(2000);
+    CHECK(out.find("sched.dispatches") != std::string::npos);
+    CHECK(out.find("METRICS END") != std::string::npos);
+    CHECK_EQ(hostWatchdogResets(), 0);
+}
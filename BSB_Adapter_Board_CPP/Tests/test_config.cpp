@@ -0,0 +1,109 @@
+#include "host_test.h"
+#include <string.h>
+#include <stddef.h>
+#include <util/crc16.h>
+#include "config.h"
+
+static void writeBehind(ConfigStore& store) {
+    for (uint16_t i = 0; i < 1000 && store.pending(); i++) {
+        store.service();
+        hostAdvanceUs(1000);
+    }
+}
+
+HOST_TEST(erased_eeprom_gives_defaults) {
+    memset(hostEeprom(), 0xFF, HOST_EEPROM_SIZE);
+    ConfigStore store;
+
+    CHECK(!store.begin());
+    CHECK_EQ(store.get().serialBaud, 9600);
+}
+
+HOST_TEST(saved_record_survives_restart) {
+    memset(hostEeprom(), 0xFF, HOST_EEPROM_SIZE);
+    ConfigStore store;
+    store.begin();
+    store.edit().serialBaud = 19200;
+    store.edit().lcdCols = 20;
+    store.save();
+    writeBehind(store);
+    CHECK(!store.pending());
+
+    ConfigStore reboot;
+    CHECK(reboot.begin());
+    CHECK_EQ(reboot.get().serialBaud, 19200);
+    CHECK_EQ(reboot.get().lcdCols, 20);
+    CHECK_EQ(reboot.sequence(), store.sequence());
+}
+
+HOST_TEST(write_behind_is_paced_by_eeprom) {
+    memset(hostEeprom(), 0xFF, HOST_EEPROM_SIZE);
+    ConfigStore store;
+    store.begin();
+    store.save();
+
+    // One byte per service() while the EEPROM is busy for 3.4 ms
+    uint64_t start = hostCycles();
+    store.service();
+    store.service();
+    CHECK(store.pending());
+    CHECK((hostCycles() - start) / 16 < 100);
+
+    writeBehind(store);
+    CHECK(!store.pending());
+}
+
+HOST_TEST(torn_write_keeps_previous_record) {
+    memset(hostEeprom(), 0xFF, HOST_EEPROM_SIZE);
+    ConfigStore store;
+    store.begin();
+    store.edit().lcdRows = 2;
+    store.save();
+    writeBehind(store);
+
+    store.edit().lcdRows = 4;
+    store.save();
+    for (uint8_t i = 0; i < 3; i++) {  // Power fails part way through
+        store.service();
+        hostAdvanceUs(4000);
+    }
+
+    ConfigStore reboot;
+    CHECK(reboot.begin());
+    CHECK_EQ(reboot.get().lcdRows, 2);
+}
+
+// Rewrites one field of the stored record and fixes up its CRC, as a
+// record written by another firmware would look
+static void patchRecord(const ConfigStore& store, size_t offset, uint8_t value) {
+    uint8_t* slot = hostEeprom() + CONFIG_EEPROM_BASE + store.slot() * CONFIG_SLOT_SIZE;
+    const uint8_t length = 6 + sizeof(BoardConfig);   // Header, see config.h
+    slot[6 + offset] = value;
+    uint16_t c = 0xFFFF;
+    for (uint8_t i = 0; i < length; i++) c = _crc_ccitt_update(c, slot[i]);
+    slot[length] = c & 0xFF;
+    slot[length + 1] = c >> 8;
+}
+
+HOST_TEST(out_of_range_fields_fall_back_to_defaults) {
+    memset(hostEeprom(), 0xFF, HOST_EEPROM_SIZE);
+    ConfigStore store;
+    store.begin();
+    store.edit().serialBaud = 0;
+    store.edit().lcdCols = 20;
+    store.edit().adcPeriod = 0;
+    store.save();
+    CHECK_EQ(store.get().serialBaud, 9600);
+    CHECK_EQ(store.get().adcPeriod, 100);
+    CHECK_EQ(store.get().lcdCols, 20);    // In range: kept
+    writeBehind(store);
+
+    patchRecord(store, offsetof(BoardConfig, lcdRows), 0);
+    patchRecord(store, offsetof(BoardConfig, adcResolution), 16);
+
+    ConfigStore reboot;
+    CHECK(reboot.begin());
+    CHECK_EQ(reboot.get().lcdRows, 2);
+    CHECK_EQ(reboot.get().adcResolution, 10);
+    CHECK_EQ(reboot.get().lcdCols, 20);
+}
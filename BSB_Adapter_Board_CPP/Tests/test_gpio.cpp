@@ -0,0 +1,55 @@
+#include "host_test.h"
+#include <avr/io.h>
+#include "gpio.h"
+#include "gpio_group.h"
+
+HOST_TEST(pin_mode_and_write_set_port_bits) {
+    pinMode(APB7, OUTPUT);
+    digitalWrite(APB7, HIGH);
+    CHECK_EQ(hostRegs[0x24], 0x80);   // DDRB
+    CHECK_EQ(hostRegs[0x25], 0x80);   // PORTB
+
+    digitalWrite(APB7, LOW);
+    CHECK_EQ(hostRegs[0x25], 0x00);
+}
+
+HOST_TEST(read_follows_pin_register) {
+    pinMode(APH0, INPUT);
+    hostRegs[0x100] = 0x01;           // PINH
+    CHECK_EQ(digitalRead(APH0), HIGH);
+    hostRegs[0x100] = 0x00;
+    CHECK_EQ(digitalRead(APH0), LOW);
+}
+
+HOST_TEST(aligned_group_is_one_port) {
+    static const uint8_t pins[8] = { APH0, APH1, APH2, APH3, APH4, APH5, APH6, APH7 };
+    PinGroup bus;
+    bus.begin(pins, 8);
+    bus.output();
+
+    CHECK_EQ(bus.portCount(), 1);
+    CHECK_EQ(hostRegs[0x101], 0xFF);  // DDRH
+
+    bus.write(0xA5);
+    CHECK_EQ(hostRegs[0x102], 0xA5);  // PORTH
+
+    hostRegs[0x100] = 0x3C;
+    CHECK_EQ(bus.read(), 0x3C);
+}
+
+HOST_TEST(scattered_group_keeps_other_pins) {
+    static const uint8_t pins[3] = { APB7, APA0, APB0 };
+    PinGroup bus;
+    bus.begin(pins, 3);
+    bus.output();
+    hostRegs[0x25] = 0x42;            // Unrelated PORTB bits
+
+    bus.write(0x07);
+    CHECK_EQ(bus.portCount(), 2);
+    CHECK_EQ(hostRegs[0x25], 0x42 | 0x81);
+    CHECK_EQ(hostRegs[0x22] & 0x01, 0x01);
+
+    bus.write(0x02);
+    CHECK_EQ(hostRegs[0x25], 0x42);
+    CHECK_EQ(hostRegs[0x22] & 0x01, 0x01);
+}
@@ -0,0 +1,106 @@
+#include "host_test.h"
+#include "lcd.h"
+#include "gpio.h"
+#include "metrics.h"
+
+// Same wiring as the board; RW is connected, so busy polling is used
+static LCD display(APG1, APB4, APE6, APH0, APH1, APH2, APH3, APH4, APH5, APH6, APH7);
+
+static void showCounter(const char* digits) {
+    display.setCursor(0, 0);
+    display.print("LCD Test - ");
+    display.print(digits);
+}
+
+HOST_TEST(refresh_sends_only_changed_cells) {
+    display.setQueued(false);
+    display.begin(16, 2);
+
+    showCounter("9");
+    CHECK_EQ(display.refresh(), 12);   // 12 characters, address already at 0
+
+    showCounter("10");
+    CHECK_EQ(display.refresh(), 3);    // Address + "10", the '1' replaces the '9'
+
+    showCounter("11");
+    CHECK_EQ(display.refresh(), 2);    // Address + '1'
+
+    showCounter("11");
+    CHECK_EQ(display.refresh(), 0);
+
+    display.invalidate();
+    CHECK_EQ(display.refresh(), 34);   // 32 characters + 2 row addresses
+}
+
+HOST_TEST(refresh_counts_bus_bytes) {
+    display.setQueued(false);
+    display.begin(16, 2);
+    uint32_t before = metricGet(METRIC_LCD_BYTES);
+
+    showCounter("42");
+    uint8_t transfers = display.refresh();
+    CHECK_EQ(metricGet(METRIC_LCD_BYTES) - before, transfers);
+    CHECK_EQ(hostRegs[0x102], '2');    // PORTH holds the last data byte
+}
+
+HOST_TEST(blocking_init_takes_power_up_delay) {
+    display.setQueued(false);
+    uint64_t start = hostCycles();
+    display.begin(16, 2);
+    uint32_t ms = (hostCycles() - start) / 16000;
+
+    CHECK(ms >= 50 && ms <= 55);
+    CHECK(display.busyPolling());
+}
+
+static uint8_t completions;
+static void onComplete() { completions++; }
+
+HOST_TEST(queued_init_returns_at_once) {
+    completions = 0;
+    display.setCompletionHandler(onComplete);
+    display.setQueued(true);
+
+    uint64_t start = hostCycles();
+    display.begin(16, 2);
+    CHECK((hostCycles() - start) / 16 < 100);
+
+    uint16_t slots = 0;
+    while (!display.idle() && slots < 1000) {
+        display.service();
+        slots++;
+    }
+    CHECK_EQ(slots, 58);               // 50 ms power-up + 4 commands with holds
+    CHECK_EQ(completions, 1);
+
+    showCounter("7");
+    uint8_t queued = display.refresh();
+    slots = 0;
+    while (!display.idle() && slots < 1000) {
+        display.service();
+        slots++;
+    }
+    CHECK_EQ(slots, queued);           // Busy flag clear: one byte per slot
+    CHECK_EQ(completions, 2);
+
+    display.setCompletionHandler(0);
+    display.setQueued(false);
+}
+
+HOST_TEST(dropped_command_forces_redraw) {
+    display.setQueued(true);
+    display.begin(16, 2);
+    showCounter("7");
+    display.refresh();
+    while (!display.idle()) display.service();
+
+    // Queue full: the clear is lost and the glass keeps its text
+    uint16_t dropped = display.dropped();
+    while (display.dropped() == dropped) display.command(0x0C);   // Display on
+    display.command(0x01);             // Clear display
+    while (!display.idle()) display.service();
+
+    CHECK_EQ(display.refresh(), 34);   // Whole screen, not just the cells a clear would change
+
+    display.setQueued(false);
+}
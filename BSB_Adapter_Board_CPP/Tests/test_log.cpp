@@ -0,0 +1,71 @@
+#include "host_test.h"
+#include <string.h>
+#include "log.h"
+#include "serial.h"
+#include "scheduler.h"
+
+static std::string drain() {
+    for (uint16_t i = 0; i < 2000; i++) {
+        logService();
+        hostAdvanceUs(100);
+    }
+    return hostUartOutput(3);
+}
+
+HOST_TEST(record_has_time_level_and_tag) {
+    Serial3.begin(115200);
+    logSetSink(&Serial3);
+    scheduler.init();
+    scheduler.start();
+    hostAdvanceUs(42000);
+
+    LOG_WARN(ADC, "alarm A%u %s", 3, "above");
+    LOG_INFO(BOARD, "ready");
+    CHECK_STR(drain(), "42 W ADC: alarm A3 above\r\n42 I BOARD: ready\r\n");
+}
+
+HOST_TEST(long_text_is_cut_with_line_end) {
+    Serial3.begin(115200);
+    logSetSink(&Serial3);
+
+    char text[LOG_LINE_MAX * 2];
+    memset(text, 'x', sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+    LOG_ERROR(LCD, "%s", text);
+
+    std::string out = drain();
+    CHECK_EQ(out.size(), LOG_LINE_MAX - 1);
+    CHECK_STR(out.substr(out.size() - 2), "\r\n");
+}
+
+HOST_TEST(full_ring_drops_whole_records) {
+    Serial3.begin(115200);
+    logSetSink(&Serial3);
+    uint16_t before = logDropped();
+
+    for (uint8_t i = 0; i < 40; i++) LOG_ERROR(SCHED, "record %u", i);
+    CHECK(logDropped() > before);
+
+    std::string out = drain();
+    CHECK_STR(out.substr(out.size() - 2), "\r\n");
+    CHECK_EQ(out.find("record 0\r\n") != std::string::npos, true);
+}
+
+HOST_TEST(service_never_waits_for_the_uart) {
+    Serial3.begin(115200);
+    logSetSink(&Serial3);
+    LOG_ERROR(BOARD, "0123456789012345678901234567890123456789");
+
+    uint64_t start = hostCycles();
+    logService();
+    uint32_t us = (hostCycles() - start) / 16;
+    CHECK(us < 100);                   // Two frames at most, no waiting
+
+    drain();
+}
+
+HOST_TEST(no_sink_discards) {
+    logSetSink(0);
+    LOG_ERROR(BOARD, "lost");
+    CHECK_STR(drain(), "");
+}
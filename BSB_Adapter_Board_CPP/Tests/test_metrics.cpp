@@ -0,0 +1,38 @@
+#include "host_test.h"
+#include <string.h>
+#include "metrics.h"
+#include "serial.h"
+
+HOST_TEST(dump_prints_kind_name_value) {
+    memset(metricValues, 0, sizeof(metricValues));
+    METRIC_ADD(SCHED_DISPATCHES, 1234);
+    METRIC_INC(SCHED_OVERRUNS);
+    METRIC_MAX(LCD_QUEUE_PEAK, 17);
+    METRIC_MAX(LCD_QUEUE_PEAK, 9);        // Peak stays
+    Serial3.begin(115200);
+
+    metricsDumpBegin();
+    CHECK(metricsDumpStep(Serial3, 3));   // Header + 3 lines
+    hostAdvanceUs(20000);
+    std::string out = hostUartOutput(3);   // uart.tx_bytes counts the dump itself
+    CHECK(out.find("METRICS " + std::to_string(METRIC_COUNT) + "\r\nC uart.tx_bytes ") == 0);
+    CHECK(out.find("\r\nC uart.rx_bytes 0\r\nC sched.dispatches 1234\r\n") ==
+          out.size() - strlen("\r\nC uart.rx_bytes 0\r\nC sched.dispatches 1234\r\n"));
+
+    while (metricsDumpStep(Serial3, 3)) {}
+    hostAdvanceUs(50000);
+    out = hostUartOutput(3);
+    CHECK(out.find("C sched.overruns 1\r\n") == 0);
+    CHECK(out.find("G lcd.queue_peak 17\r\n") != std::string::npos);
+    CHECK(out.find("C log.drops 0\r\nMETRICS END\r\n") != std::string::npos);
+    CHECK(!metricsDumpStep(Serial3, 3));  // Finished until the next begin
+}
+
+HOST_TEST(name_is_truncated_to_buffer) {
+    char name[6];
+    metricName(METRIC_CONFIG_WRITES, name, sizeof(name));
+    CHECK_STR(name, "confi");
+    metricName(METRIC_COUNT, name, sizeof(name));
+    CHECK_STR(name, "");
+    CHECK_EQ(metricKind(METRIC_LCD_QUEUE_PEAK), METRIC_GAUGE);
+}
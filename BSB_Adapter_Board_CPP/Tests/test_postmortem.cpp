@@ -0,0 +1,103 @@
+#include "host_test.h"
+#include <avr/io.h>
+#include "postmortem.h"
+#include "serial.h"
+#include "log.h"
+
+// Runs the paced report until it has finished
+static std::string report(PostMortem& pm) {
+    for (uint16_t i = 0; i < 2000 && pm.reportStep(); i++) {
+        logService();
+        hostAdvanceUs(100);
+    }
+    for (uint16_t i = 0; i < 2000 && !logIdle(); i++) {
+        logService();
+        hostAdvanceUs(100);
+    }
+    return hostUartOutput(3);
+}
+
+HOST_TEST(full_log_report_keeps_its_window) {
+    PostMortem pm;
+    pm.clear();
+    for (uint8_t i = 0; i < PM_ENTRIES; ++i) {
+        pm.log(PM_OVERFLOW, i);
+    }
+    Serial3.begin(115200);
+    logSetSink(&Serial3);
+
+    // An event arrives while the first entries are on their way
+    std::string out;
+    while (out.find("src=1 ") == std::string::npos && pm.reportStep()) {
+        logService();
+        hostAdvanceUs(100);
+        out += hostUartOutput(3);
+    }
+    pm.log(PM_OVERFLOW, 100);
+    out += report(pm);
+
+    for (uint8_t i = 0; i < PM_ENTRIES; ++i) {
+        std::string line = "overflow src=" + std::to_string(i) + " ";
+        CHECK(out.find(line) != std::string::npos);
+    }
+    CHECK(out.find("src=100 ") == std::string::npos);
+    logSetSink(0);
+}
+
+HOST_TEST(log_survives_warm_reset) {
+    PostMortem pm;
+    pm.clear();
+    pm.log(PM_TASK_OVERRUN, 3, 20);
+    pm.log(PM_OVERFLOW, PM_SRC_LCD_QUEUE);
+    pm.log(PM_OVERFLOW, PM_SRC_LCD_QUEUE);  // Repeat: same entry
+
+    hostReset();                            // .noinit RAM is kept
+    pm.begin(1 << WDRF, 2, 5);
+    Serial3.begin(115200);
+    logSetSink(&Serial3);
+    std::string out = report(pm);
+
+    CHECK(out.find("Post-mortem log: 3") != std::string::npos);
+    CHECK(out.find("overrun task=3 v=20 x1") != std::string::npos);
+    CHECK(out.find("overflow src=3 v=0 x2") != std::string::npos);
+    CHECK(out.find("reset mcusr=8 v=517 x1") != std::string::npos);  // Cause 2, task 5
+    CHECK(out.find("overrun") < out.find("reset"));                 // Oldest first
+    logSetSink(0);
+}
+
+HOST_TEST(damaged_entry_is_dropped) {
+    PostMortem pm;
+    pm.clear();
+    pm.log(PM_TASK_OVERRUN, 1, 10);
+    pm.log(PM_TASK_OVERRUN, 2, 10);
+    pm.log(PM_TASK_OVERRUN, 3, 10);
+    pmEntries[1].value ^= 0x40;             // Torn by a reset mid-write
+
+    hostReset();
+    pm.begin(1 << EXTRF, 0, 0xFF);
+    Serial3.begin(115200);
+    logSetSink(&Serial3);
+    std::string out = report(pm);
+
+    CHECK(out.find("overrun task=1 ") != std::string::npos);
+    CHECK(out.find("overrun task=2 ") == std::string::npos);
+    CHECK(out.find("overrun task=3 ") != std::string::npos);
+    logSetSink(0);
+}
+
+HOST_TEST(damaged_header_clears_log) {
+    PostMortem pm;
+    pm.clear();
+    pm.log(PM_TASK_OVERRUN, 1, 10);
+    pmHeader.crc ^= 1;                      // Random RAM after power-on
+
+    hostReset();
+    pm.begin(1 << PORF, 0, 0xFF);
+    Serial3.begin(115200);
+    logSetSink(&Serial3);
+    std::string out = report(pm);
+
+    CHECK(out.find("Post-mortem log: 1") != std::string::npos);   // Only this reset
+    CHECK(out.find("overrun") == std::string::npos);
+    logSetSink(0);
+}
@@ -0,0 +1,143 @@
+#include "host_test.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/delay.h>
+#include "scheduler.h"
+#include "metrics.h"
+
+static uint8_t order[8];
+static uint8_t orderCount;
+static uint16_t fastRuns;
+static uint16_t slowRuns;
+
+static void fastTask() { fastRuns++; if (orderCount < sizeof(order)) order[orderCount++] = 1; }
+static void slowTask() { slowRuns++; if (orderCount < sizeof(order)) order[orderCount++] = 2; }
+static void busyTask() { slowRuns++; _delay_ms(5); }
+
+static void startTimer() {
+    scheduler.init();
+    scheduler.start();
+    fastRuns = slowRuns = 0;
+    orderCount = 0;
+}
+
+HOST_TEST(tick_is_one_millisecond) {
+    startTimer();
+    uint32_t start = schedulerTicks();
+
+    hostAdvanceUs(100000);
+    CHECK_EQ(schedulerTicks() - start, 100);
+    CHECK_EQ(hostInterrupts(), 100);
+}
+
+HOST_TEST(periodic_tasks_run_at_their_period) {
+    startTimer();
+    scheduler.addTask(fastTask, 1, 2);
+    scheduler.addTask(slowTask, 2, 10);
+
+    hostRunScheduler(100);
+    CHECK_EQ(fastRuns, 50);
+    CHECK_EQ(slowRuns, 10);
+
+    scheduler.removeTask(fastTask);
+    scheduler.removeTask(slowTask);
+}
+
+HOST_TEST(higher_priority_runs_first) {
+    startTimer();
+    scheduler.addTask(slowTask, 5, 10);
+    scheduler.addTask(fastTask, 1, 10);
+
+    hostRunScheduler(10);
+    CHECK_EQ(orderCount, 2);
+    CHECK_EQ(order[0], 1);
+    CHECK_EQ(order[1], 2);
+
+    scheduler.removeTask(fastTask);
+    scheduler.removeTask(slowTask);
+}
+
+HOST_TEST(tasks_wait_for_readiness_flags) {
+    startTimer();
+    scheduler.addTask(fastTask, 1, 1, 0, false, 0x80);
+
+    hostRunScheduler(20);
+    CHECK_EQ(fastRuns, 0);
+
+    scheduler.setReady(0x80);
+    hostRunScheduler(20);
+    CHECK_EQ(fastRuns, 20);
+
+    scheduler.removeTask(fastTask);
+}
+
+HOST_TEST(runtime_budget_counts_overruns) {
+    startTimer();
+    uint32_t before = metricGet(METRIC_SCHED_OVERRUNS);
+    scheduler.addTask(busyTask, 1, 10, 2);
+
+    // Each run is 5 ms against a 2 ms budget: one overrun per run, not per tick
+    hostRunScheduler(30);
+    CHECK(slowRuns >= 3);
+    CHECK_EQ(metricGet(METRIC_SCHED_OVERRUNS) - before, slowRuns);
+
+    scheduler.removeTask(busyTask);
+}
+
+HOST_TEST(micros_is_monotonic) {
+    startTimer();
+    uint32_t last = micros();
+    bool ok = true;
+
+    // Odd steps land on every Timer0 phase, including the compare cycle
+    for (uint32_t i = 0; i < 20000 && ok; i++) {
+        hostAdvanceCycles(1 + i % 7);
+        uint32_t now = micros();
+        if ((int32_t)(now - last) < 0) ok = false;
+        last = now;
+    }
+    CHECK(ok);
+}
+
+HOST_TEST(micros_counts_pending_tick) {
+    startTimer();
+    hostAdvanceUs(5000);
+    uint32_t before = micros();
+
+    // Cross a compare match with interrupts off: the ISR cannot run yet
+    cli();
+    hostAdvanceUs(1000);
+    uint32_t pending = micros();
+    CHECK(pending >= before + 996);
+    CHECK(pending <= before + 1012);
+    sei();
+
+    hostAdvanceCycles(8);   // ISR runs
+    CHECK(micros() >= pending);
+}
+
+HOST_TEST(micros_tracks_cycles) {
+    startTimer();
+    uint64_t startCycles = hostCycles();
+    uint32_t start = micros();
+
+    hostAdvanceUs(12345);
+    uint32_t expected = (hostCycles() - startCycles) / 16;
+    uint32_t measured = micros() - start;
+    CHECK(measured + 8 >= expected && measured <= expected + 8);
+}
+
+HOST_TEST(elapsed_micros_every_has_no_drift) {
+    startTimer();
+    uint64_t startCycles = hostCycles();
+    ElapsedMicros poll;
+    uint16_t hits = 0;
+
+    // The micros() reads take time too, so count against the cycle counter
+    for (uint16_t i = 0; i < 1000; i++) {
+        hostAdvanceCycles(160);   // 10 us
+        if (poll.every(250)) hits++;
+    }
+    uint32_t expected = (hostCycles() - startCycles) / 16 / 250;
+    CHECK(hits + 1u >= expected && hits <= expected);
+}
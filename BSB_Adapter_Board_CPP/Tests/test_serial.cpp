@@ -0,0 +1,63 @@
+#include "host_test.h"
+#include "serial.h"
+
+HOST_TEST(print_formats_numbers_and_lines) {
+    Serial3.begin(115200);
+    Serial3.print("v=");
+    Serial3.print(-42);
+    Serial3.println(" ok");
+    Serial3.println(1234);
+
+    hostAdvanceUs(2000);
+    CHECK_STR(hostUartOutput(3), "v=-42 ok\r\n1234\r\n");
+    CHECK_STR(hostUartOutput(0), "");
+}
+
+HOST_TEST(write_waits_for_the_data_register) {
+    Serial3.begin(115200);   // UBRR 7: 125 kBd, 80 us per frame
+
+    uint64_t start = hostCycles();
+    Serial3.print("0123456789");
+    uint32_t us = (hostCycles() - start) / 16;
+
+    // Shifter + UDR take two bytes at once, the other eight wait a frame each
+    CHECK(us >= 8 * 80 - 2 && us <= 8 * 80 + 10);
+    CHECK(Serial3.txBusy());
+    CHECK(!Serial3.writeReady());
+
+    hostAdvanceUs(200);
+    CHECK(!Serial3.txBusy());
+    CHECK(Serial3.writeReady());
+    CHECK_STR(hostUartOutput(3), "0123456789");
+}
+
+HOST_TEST(transmitter_off_drops_bytes) {
+    Serial3.write('x');
+    hostAdvanceUs(1000);
+    CHECK_STR(hostUartOutput(3), "");
+}
+
+HOST_TEST(read_returns_injected_bytes) {
+    Serial3.begin(115200);
+    CHECK(!Serial3.available());
+    CHECK_EQ(Serial3.read(), -1);
+
+    hostUartInject(3, "ab");
+    CHECK(Serial3.available());
+    CHECK_EQ(Serial3.read(), 'a');
+    CHECK_EQ(Serial3.read(), 'b');
+    CHECK(!Serial3.available());
+    CHECK_EQ(Serial3.read(), -1);
+}
+
+HOST_TEST(ports_are_independent) {
+    Serial.begin(9600);
+    Serial1.begin(9600);
+    Serial.print("zero");
+    Serial1.print("one");
+
+    hostAdvanceUs(20000);
+    CHECK_STR(hostUartOutput(0), "zero");
+    CHECK_STR(hostUartOutput(1), "one");
+    CHECK_STR(hostUartOutput(3), "");
+}
@@ -0,0 +1,72 @@
+#include "host_test.h"
+#include <math.h>
+#include "adc_temp.h"
+
+// Reference curves, same circuit as Tools/gen_temp_lut.py: sensor to GND,
+// series resistor to AVcc, AVcc as reference
+static double ntcCelsius(double raw) {
+    double r = 10000.0 * raw / (1024.0 - raw);
+    return 1.0 / (1.0 / 298.15 + log(r / 10000.0) / 3950.0) - 273.15;
+}
+
+static double pt1000Celsius(double raw) {
+    const double a = 3.9083e-3, b = -5.775e-7;
+    double r = 1000.0 * raw / (1024.0 - raw);
+    return (-a + sqrt(a * a - 4.0 * b * (1.0 - r / 1000.0))) / (2.0 * b);
+}
+
+// Interpolated result within 0.15 degC of the curve
+static bool nearCurve(uint8_t channel, uint16_t raw, uint8_t bits, double celsius) {
+    int16_t t = adcTemp.toCentiCelsius(channel, raw, bits);
+    return t != TEMP_INVALID && fabs(t / 100.0 - celsius) <= 0.15;
+}
+
+HOST_TEST(ntc_follows_curve_over_valid_range) {
+    adcTemp.setSensor(0, TEMP_SENSOR_NTC10K);
+
+    // Hot end, steepest part, middle, cold end
+    static const uint16_t raws[] = { 21, 22, 30, 48, 100, 300, 512, 800, 950, 990, 999 };
+    for (uint8_t i = 0; i < sizeof(raws) / sizeof(raws[0]); ++i) {
+        CHECK(nearCurve(0, raws[i], 10, ntcCelsius(raws[i])));
+    }
+
+    // Every count, not just the picked ones
+    bool ok = true;
+    for (uint16_t raw = 21; raw <= 999 && ok; ++raw) ok = nearCurve(0, raw, 10, ntcCelsius(raw));
+    CHECK(ok);
+}
+
+HOST_TEST(ntc_uses_extra_bits) {
+    adcTemp.setSensor(0, TEMP_SENSOR_NTC10K);
+
+    // 12-bit 4 * 48 + 2 sits between 10-bit counts 48 and 49
+    CHECK(nearCurve(0, 4 * 48 + 2, 12, ntcCelsius(48.5)));
+    CHECK(nearCurve(0, 4 * 998 + 3, 12, ntcCelsius(998.75)));
+}
+
+HOST_TEST(ntc_out_of_range_is_invalid) {
+    adcTemp.setSensor(0, TEMP_SENSOR_NTC10K);
+
+    CHECK_EQ(adcTemp.toCentiCelsius(0, 20), TEMP_INVALID);     // Shorted
+    CHECK_EQ(adcTemp.toCentiCelsius(0, 1000), TEMP_INVALID);   // Open
+    CHECK_EQ(adcTemp.toCentiCelsius(0, 1023), TEMP_INVALID);
+}
+
+HOST_TEST(pt1000_follows_curve_over_valid_range) {
+    adcTemp.setSensor(1, TEMP_SENSOR_PT1000);
+
+    bool ok = true;
+    for (uint16_t raw = 457; raw <= 675 && ok; ++raw) ok = nearCurve(1, raw, 10, pt1000Celsius(raw));
+    CHECK(ok);
+    CHECK(nearCurve(1, 512, 10, pt1000Celsius(512)));          // 0 degC
+    CHECK_EQ(adcTemp.toCentiCelsius(1, 456), TEMP_INVALID);
+    CHECK_EQ(adcTemp.toCentiCelsius(1, 676), TEMP_INVALID);
+}
+
+HOST_TEST(calibration_applies_gain_then_offset) {
+    TempCalibration cal = { TEMP_SENSOR_PT1000, 50, TEMP_GAIN_UNITY / 2 };
+    adcTemp.setCalibration(2, cal);
+
+    int16_t t = adcTemp.toCentiCelsius(2, 600);
+    CHECK(fabs(t - (pt1000Celsius(600) * 100.0 / 2 + 50)) <= 10);
+}
@@ -0,0 +1,61 @@
+#include "host_test.h"
+#include "trace.h"
+#include "serial.h"
+
+static std::string dump() {
+    traceDumpBegin();
+    while (traceDumpStep(Serial3, 8)) {}
+    traceDumpStep(Serial3, 8);
+    hostAdvanceUs(200000);
+    return hostUartOutput(3);
+}
+
+HOST_TEST(mask_selects_categories) {
+    Serial3.begin(115200);
+    traceClear();
+    traceSetMask(TRACE_CAT_MARK);
+    schedulerTickCount = 0x1234;
+
+    TRACE_MARK_EVT(0x5A);
+    TRACE_UART_TX_EVT('x');               // Category off
+    TRACE_TASK_BEGIN_EVT(3);
+
+    CHECK_STR(dump(), "TRACE 1\r\nT 1234 0 8 5a\r\nTRACE END\r\n");
+    traceSetMask(TRACE_CAT_DEFAULT);
+    schedulerTickCount = 0;
+}
+
+HOST_TEST(dump_starts_at_oldest_after_wrap) {
+    Serial3.begin(1000000);
+    traceClear();
+    traceSetMask(TRACE_CAT_MARK);
+
+    for (uint16_t i = 0; i < TRACE_SIZE + 3; ++i) {
+        TRACE_MARK_EVT(i);
+    }
+    std::string out = dump();
+    CHECK(out.find("TRACE 128\r\nT 0 0 8 3\r\n") == 0);
+    CHECK(out.find("T 0 0 8 82\r\nTRACE END\r\n") != std::string::npos);  // Newest: 130
+
+    CHECK_STR(dump(), "TRACE 0\r\nTRACE END\r\n");  // Ring cleared by the dump
+    traceSetMask(TRACE_CAT_DEFAULT);
+}
+
+HOST_TEST(mask_change_waits_for_dump) {
+    Serial3.begin(1000000);
+    traceClear();
+    traceSetMask(TRACE_CAT_MARK);
+    TRACE_MARK_EVT(1);
+
+    traceDumpBegin();
+    traceSetMask(TRACE_CAT_TASK);         // Deferred until the dump ends
+    TRACE_MARK_EVT(2);                    // Frozen: not recorded
+    while (traceDumpStep(Serial3, 8)) {}
+    CHECK_EQ(traceMask, TRACE_CAT_TASK);
+
+    TRACE_TASK_BEGIN_EVT(4);
+    hostAdvanceUs(50000);
+    hostUartOutput(3);
+    CHECK_STR(dump(), "TRACE 1\r\nT 0 0 1 4\r\nTRACE END\r\n");
+    traceSetMask(TRACE_CAT_DEFAULT);
+}
@@ -0,0 +1,65 @@
+#include "host_test.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "watchdog.h"
+#include "postmortem.h"
+#include "serial.h"
+#include "log.h"
+
+static bool interruptArmed() {
+    return hostRegs[0x60] & (1 << WDIE);   // WDTCSR
+}
+
+HOST_TEST(timeout_warns_before_it_resets) {
+    watchdog.begin(WDTO_1S);
+    sei();
+    CHECK(interruptArmed());
+
+    hostAdvanceUs(1100000);                 // Nobody feeds: WDT_vect
+    CHECK_EQ(hostInterrupts(), 1);
+    CHECK(!interruptArmed());
+    CHECK_EQ(hostWatchdogResets(), 0);
+
+    hostAdvanceUs(1100000);                 // Second timeout resets
+    CHECK_EQ(hostWatchdogResets(), 1);
+}
+
+HOST_TEST(feed_after_recovery_rearms_warning) {
+    watchdog.begin(WDTO_1S);
+    sei();
+
+    hostAdvanceUs(1100000);
+    CHECK(!interruptArmed());
+
+    watchdog.feed();                        // Tasks healthy again
+    CHECK(interruptArmed());
+
+    hostAdvanceUs(1100000);                 // Warns again instead of resetting
+    CHECK_EQ(hostInterrupts(), 2);
+    CHECK_EQ(hostWatchdogResets(), 0);
+    watchdog.feed();
+}
+
+HOST_TEST(feed_after_recovery_drops_cause) {
+    watchdog.begin(WDTO_1S);
+    postmortem.clear();
+
+    watchdog.flag(WDT_CAUSE_STARVED, 4);
+    watchdog.flag(WDT_CAUSE_OVERRUN, 5);    // First cause wins
+    watchdog.feed();
+    watchdog.flag(WDT_CAUSE_OVERRUN, 6);    // Recorded: the stale one is gone
+
+    Serial3.begin(115200);
+    logSetSink(&Serial3);
+    for (uint16_t i = 0; i < 200; i++) {
+        postmortem.reportStep();
+        logService();
+        hostAdvanceUs(100);
+    }
+    std::string out = hostUartOutput(3);
+
+    CHECK(out.find("watchdog cause=3 v=4") != std::string::npos);
+    CHECK(out.find("watchdog cause=2 v=5") == std::string::npos);
+    CHECK(out.find("watchdog cause=2 v=6") != std::string::npos);
+    watchdog.feed();
+}
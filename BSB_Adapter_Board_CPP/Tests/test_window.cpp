@@ -0,0 +1,102 @@
+#include "host_test.h"
+#include "adc_window.h"
+
+static void drain(AdcWindowComparator& windows) {
+    AdcWindowEvent event;
+    while (windows.readEvent(event)) {}
+}
+
+HOST_TEST(full_queue_holds_transition_back) {
+    AdcWindowComparator windows;
+    for (uint8_t ch = 0; ch < 8; ++ch) {
+        windows.setWindow(ch, 100, 900, 10);
+    }
+    for (uint8_t ch = 0; ch < ADC_WINDOW_QUEUE - 1; ++ch) {
+        windows.check(ch, 950);           // Fills the queue
+    }
+
+    windows.check(7, 950);                // Lost for now, but not forgotten
+    CHECK_EQ(windows.dropped(), 1);
+    CHECK_EQ(windows.state(7), ADC_WINDOW_UNKNOWN);
+    windows.check(7, 950);                // Same value: still retried
+    CHECK_EQ(windows.dropped(), 2);
+
+    drain(windows);
+    windows.check(7, 950);
+    AdcWindowEvent event;
+    CHECK(windows.readEvent(event));
+    CHECK_EQ(event.channel, 7);
+    CHECK_EQ(event.state, ADC_WINDOW_ABOVE);
+    CHECK_EQ(windows.state(7), ADC_WINDOW_ABOVE);
+}
+
+HOST_TEST(window_reports_enter_and_leave) {
+    AdcWindowComparator windows;
+    windows.setWindow(2, 100, 900, 10);
+    AdcWindowEvent event;
+
+    windows.check(2, 500);                // First result inside: silent
+    CHECK(!windows.readEvent(event));
+    CHECK_EQ(windows.state(2), ADC_WINDOW_INSIDE);
+
+    windows.check(2, 950);
+    CHECK(windows.readEvent(event));
+    CHECK_EQ(event.channel, 2);
+    CHECK_EQ(event.state, ADC_WINDOW_ABOVE);
+    CHECK_EQ(event.value, 950);
+
+    windows.check(2, 500);
+    CHECK(windows.readEvent(event));
+    CHECK_EQ(event.state, ADC_WINDOW_INSIDE);
+
+    windows.check(2, 20);
+    CHECK(windows.readEvent(event));
+    CHECK_EQ(event.state, ADC_WINDOW_BELOW);
+
+    windows.check(3, 20);                 // Unwatched channel
+    CHECK(!windows.readEvent(event));
+
+    windows.clearWindow(2);
+    windows.check(2, 500);
+    CHECK(!windows.readEvent(event));
+}
+
+HOST_TEST(window_hysteresis_holds_state) {
+    AdcWindowComparator windows;
+    windows.setWindow(0, 100, 900, 10);
+    AdcWindowEvent event;
+
+    windows.check(0, 950);                // First result outside: reported
+    CHECK(windows.readEvent(event));
+    windows.check(0, 895);                // Inside, but less than 10 counts
+    CHECK(!windows.readEvent(event));
+    CHECK_EQ(windows.state(0), ADC_WINDOW_ABOVE);
+    windows.check(0, 890);
+    CHECK(windows.readEvent(event));
+    CHECK_EQ(event.state, ADC_WINDOW_INSIDE);
+
+    windows.check(0, 99);
+    CHECK(windows.readEvent(event));
+    windows.check(0, 105);
+    CHECK(!windows.readEvent(event));
+    CHECK_EQ(windows.state(0), ADC_WINDOW_BELOW);
+    windows.check(0, 110);
+    CHECK(windows.readEvent(event));
+    CHECK_EQ(event.state, ADC_WINDOW_INSIDE);
+}
+
+static uint8_t notified;
+static void onEvent() { notified++; }
+
+HOST_TEST(window_handler_runs_per_event) {
+    AdcWindowComparator windows;
+    windows.setWindow(0, 100, 900, 0);
+    windows.setHandler(onEvent);
+    notified = 0;
+
+    windows.check(0, 950);
+    windows.check(0, 960);                // Still above: no event
+    windows.check(0, 500);
+    CHECK_EQ(notified, 2);
+    drain(windows);
+}
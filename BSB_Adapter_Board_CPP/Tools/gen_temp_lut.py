@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""
+Generates the PROGMEM temperature tables in Drivers/adc/adc_temp.cpp.
+
+Each table maps a 10-bit ADC reading to centi-degrees Celsius. The points
+are laid out in segments; inside a segment they are 2^shift counts apart,
+so the firmware finds its entry with shifts only. Steep parts of a curve
+(both ends of the NTC) get narrow segments, flat parts wide ones. Every
+point is taken from the sensor curve itself, including the ones just
+outside the valid range, so interpolation next to rawMin/rawMax is as
+good as in the middle. The script prints the worst interpolation error
+over the valid range with each table.
+
+Circuit assumed for every sensor: series resistor from AVcc to the ADC pin,
+sensor from the ADC pin to GND, AVcc used as ADC reference:
+
+    ratio = raw / 1024 = R_sensor / (R_series + R_sensor)
+
+Usage:
+    python3 gen_temp_lut.py > tables.txt   # paste into adc_temp.cpp
+"""
+
+import math
+
+SENSORS = [
+    # C name, series resistor (ohm), R(T) function, valid range (degC),
+    # segments as (raw_start, shift, points); each segment ends where the
+    # next one starts, the last one at or above the valid range
+    ("Ntc10k", 10000.0,
+     # 10 kOhm @ 25 degC, B = 3950 K
+     lambda t: 10000.0 * math.exp(3950.0 * (1.0 / (t + 273.15) - 1.0 / 298.15)),
+     (-40.0, 150.0),
+     [(20, 1, 6), (32, 2, 8), (64, 3, 8), (128, 4, 6), (224, 5, 21), (896, 4, 4), (960, 2, 10)]),
+    ("Pt1000", 1000.0,
+     # Callendar-Van Dusen (IEC 60751); C term below 0 degC is negligible here
+     lambda t: 1000.0 * (1.0 + 3.9083e-3 * t - 5.775e-7 * t * t),
+     (-50.0, 250.0),
+     [(456, 3, 28)]),
+]
+
+
+def ratio_at(r_series, r_of_t, t):
+    r = r_of_t(t)
+    return r / (r_series + r)
+
+
+def temp_at_ratio(r_series, r_of_t, ratio):
+    """Inverts ratio(T) by bisection over a bracket wider than any valid
+    range, so points just outside it still lie on the curve."""
+    a, b = -100.0, 400.0
+    rising = ratio_at(r_series, r_of_t, b) > ratio_at(r_series, r_of_t, a)
+    for _ in range(80):
+        m = (a + b) / 2.0
+        if (ratio_at(r_series, r_of_t, m) < ratio) == rising:
+            a = m
+        else:
+            b = m
+    return (a + b) / 2.0
+
+
+def points_of(segments):
+    raws = []
+    for start, shift, count in segments:
+        raws.extend(start + (i << shift) for i in range(count))
+    start, shift, count = segments[-1]
+    raws.append(start + (count << shift))
+    return raws
+
+
+def worst_error(r_series, r_of_t, raws, values, raw_min, raw_max):
+    worst = 0.0
+    for k in range(raw_min * 8, raw_max * 8 + 1):
+        x = k / 8.0
+        i = max(j for j in range(len(raws) - 1) if raws[j] <= x)
+        t = values[i] + (values[i + 1] - values[i]) * (x - raws[i]) / (raws[i + 1] - raws[i])
+        worst = max(worst, abs(t / 100.0 - temp_at_ratio(r_series, r_of_t, x / 1024.0)))
+    return worst
+
+
+def main():
+    for name, r_series, r_of_t, (lo, hi), segments in SENSORS:
+        r_lo = ratio_at(r_series, r_of_t, lo) * 1024.0
+        r_hi = ratio_at(r_series, r_of_t, hi) * 1024.0
+        raw_min = int(math.ceil(min(r_lo, r_hi)))
+        raw_max = int(math.floor(max(r_lo, r_hi)))
+
+        raws = points_of(segments)
+        assert raws[0] <= raw_min and raw_max < raws[-1] <= 1023, name
+        values = [int(round(temp_at_ratio(r_series, r_of_t, raw / 1024.0) * 100.0))
+                  for raw in raws]
+        error = worst_error(r_series, r_of_t, raws, values, raw_min, raw_max)
+
+        print("// Series %d ohm, valid raw %d..%d, %d points, max error %.2f degC"
+              % (r_series, raw_min, raw_max, len(raws), error))
+        print("static const int16_t lut%s[%d] PROGMEM = {" % (name, len(raws)))
+        for row in range(0, len(raws), 8):
+            chunk = ", ".join("%6d" % v for v in values[row:row + 8])
+            sep = "," if row + 8 < len(raws) else ""
+            print("    " + chunk + sep)
+        print("};")
+        print()
+
+        first = 0
+        print("static const TempLutSegment seg%s[%d] PROGMEM = {" % (name, len(segments)))
+        for start, shift, count in segments:
+            print("    { %4d, %d, %2d }," % (start, shift, first))
+            first += count
+        print("};")
+        print()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+"""
+Converts a trace dump captured from the Serial3 console into a Chrome /
+Perfetto JSON timeline (open in chrome://tracing or ui.perfetto.dev).
+
+The firmware prints the ring after 'T' (see Core/trace.h):
+
+    TRACE 57
+    T 1a2b 3f 1 4        tick(ms, 16 bit) sub(TCNT0, 4 us) id arg, in hex
+    ...
+    TRACE END
+
+Everything else in the capture is ignored, so a plain terminal log works.
+Task and ISR begin/end pairs become duration slices; UART bytes, ADC
+results and marks become instant events.
+
+A record taken while the Timer0 compare interrupt was still pending can
+carry the old tick with the new TCNT0 value; it shows up as a step back
+of up to 1 ms and is moved forward by one tick.
+
+Usage:
+    python3 trace2json.py capture.txt > trace.json
+    python3 trace2json.py capture.txt --tasks blink,uart3,lcd,lcdService > trace.json
+"""
+
+import argparse
+import json
+import sys
+
+US_PER_TICK = 1000
+US_PER_SUB = 4          # Timer0 prescaler 64 at 16 MHz
+TICK_WRAP = 1 << 16
+
+# Event IDs, keep in sync with Core/trace.h
+TASK_BEGIN = 0x01
+TASK_END = 0x02
+ISR_ENTER = 0x03
+ISR_EXIT = 0x04
+UART_TX = 0x05
+UART_RX = 0x06
+ADC_DONE = 0x07
+MARK = 0x08
+
+ISR_NAMES = {0: "TIMER0_COMPA", 1: "ADC", 2: "WDT"}
+
+TID_TASKS = 1
+TID_ISR = 2
+TID_UART = 3
+TID_ADC = 4
+TID_MARK = 5
+
+
+def parse_records(lines):
+    """Yields (tick, sub, id, arg) for every 'T' line of every dump."""
+    for line in lines:
+        parts = line.split()
+        if len(parts) != 5 or parts[0] != "T":
+            continue
+        try:
+            yield tuple(int(p, 16) for p in parts[1:])
+        except ValueError:
+            continue
+
+
+def timestamps(records):
+    """Turns (tick, sub) into monotonic microseconds from the first record."""
+    offset = 0
+    last = None
+    for tick, sub, eid, arg in records:
+        t = offset + tick * US_PER_TICK + sub * US_PER_SUB
+        if last is not None and t < last:
+            if last - t <= US_PER_TICK:
+                t += US_PER_TICK            # Compare match still pending
+            else:
+                offset += TICK_WRAP * US_PER_TICK
+                t += TICK_WRAP * US_PER_TICK
+        last = t
+        yield t, eid, arg
+
+
+def char_name(byte):
+    if 32 <= byte < 127:
+        return "'%s'" % chr(byte)
+    return "0x%02x" % byte
+
+
+def convert(records, task_names):
+    events = [
+        {"ph": "M", "pid": 1, "name": "process_name", "args": {"name": "BSB Adapter Board"}},
+    ]
+    for tid, name in ((TID_TASKS, "tasks"), (TID_ISR, "ISRs"), (TID_UART, "UART"),
+                      (TID_ADC, "ADC"), (TID_MARK, "marks")):
+        events.append({"ph": "M", "pid": 1, "tid": tid, "name": "thread_name",
+                       "args": {"name": name}})
+
+    start = None
+    for t, eid, arg in timestamps(records):
+        if start is None:
+            start = t
+        ts = t - start
+        ev = {"pid": 1, "ts": ts}
+
+        if eid in (TASK_BEGIN, TASK_END):
+            name = task_names[arg] if arg < len(task_names) else "task%d" % arg
+            ev.update(ph="B" if eid == TASK_BEGIN else "E", tid=TID_TASKS, name=name)
+        elif eid in (ISR_ENTER, ISR_EXIT):
+            ev.update(ph="B" if eid == ISR_ENTER else "E", tid=TID_ISR,
+                      name=ISR_NAMES.get(arg, "isr%d" % arg))
+        elif eid in (UART_TX, UART_RX):
+            ev.update(ph="i", s="t", tid=TID_UART,
+                      name=("TX " if eid == UART_TX else "RX ") + char_name(arg))
+        elif eid == ADC_DONE:
+            ev.update(ph="i", s="t", tid=TID_ADC, name="A%d" % arg)
+        elif eid == MARK:
+            ev.update(ph="i", s="t", tid=TID_MARK, name="mark %d" % arg)
+        else:
+            continue
+        events.append(ev)
+
+    return {"traceEvents": events, "displayTimeUnit": "ms"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("capture", help="console log containing TRACE dumps ('-' = stdin)")
+    parser.add_argument("--tasks", default="",
+                        help="comma-separated task names by scheduler slot")
+    args = parser.parse_args()
+
+    src = sys.stdin if args.capture == "-" else open(args.capture, encoding="ascii", errors="replace")
+    with src:
+        records = list(parse_records(src))
+
+    task_names = [n for n in args.tasks.split(",")] if args.tasks else []
+    json.dump(convert(records, task_names), sys.stdout, indent=1)
+    sys.stdout.write("\n")
+
+
+if __name__ == "__main__":
+    main()